@@ -80,7 +80,7 @@ passes = ["flat", "shaded", "shadow"]
 
 fshaders = ["blend", "compositor", "post-process"]
 vshaders = ["full-vertex"]
-cshaders = ["ray-march"]
+cshaders = ["ray-march", "light-cull", "depth-reduce"]
 standalone = fshaders + vshaders + cshaders
 
 processes: list[tuple[subprocess.Popen, str]] = []
@@ -134,7 +134,7 @@ def process_shader(name: str, entry: str, output: str | None = None, /) -> None:
         eactions.append(action)
 
 
-def process_geometry_shader(name: str, /, *, has_transparency: bool) -> None:
+def process_geometry_shader(name: str, /, *, has_transparency: bool, has_depth: bool) -> None:
     if generate:
         ffile = f"{name}.slang"
         ginput = ipath / ffile
@@ -150,13 +150,15 @@ def process_geometry_shader(name: str, /, *, has_transparency: bool) -> None:
     process_shader(name, "mainFSO", f"{name}-frag-opaque")
     if has_transparency:
         process_shader(name, "mainFST", f"{name}-frag-transparent")
+    if has_depth:
+        process_shader(name, "mainFSD", f"{name}-frag-depth")
 
 
 for dim in dims:
     for geo in geos:
         for rpass in passes:
             name = f"{geo}-{rpass}-{dim}"
-            process_geometry_shader(name, has_transparency=rpass != "shadow")
+            process_geometry_shader(name, has_transparency=rpass != "shadow", has_depth=rpass == "shaded")
 
 for f in fshaders:
     process_shader(f, "mainFS")
@@ -189,6 +191,7 @@ with hpp.scope("namespace Onyx", indent=0):
             "ten<ShaderBinary, D_Count, RenderPass_Count, Geometry_Count> VertexShaders;"
             "ten<ShaderBinary, D_Count, RenderPass_Count, Geometry_Count> OpaqueFragmentShaders;"
             "ten<ShaderBinary, D_Count, RenderPass_Count, Geometry_Count> TransparentFragmentShaders;"
+            "ten<ShaderBinary, D_Count, Geometry_Count> DepthFragmentShaders;"
         )
         for shader in standalone:
             hpp(f"ShaderBinary {Convoy.to_pascal_case(shader)};")
@@ -203,6 +206,7 @@ with hpp.scope("namespace Onyx", indent=0):
                     name = f"{geo}_{rpass}_{dim}"
                     fopaque = f"{name}_frag_opaque_spv"
                     ftransparent = f"{name}_frag_transparent_spv"
+                    fdepth = f"{name}_frag_depth_spv"
                     vshader = f"{name}_vert_spv"
 
                     d = "D2" if dim == "2D" else "D3"
@@ -219,6 +223,9 @@ with hpp.scope("namespace Onyx", indent=0):
                         hpp(
                             f"g_ShaderBinaryData.TransparentFragmentShaders[{d} - 2][{r}][{g}].Count = {ftransparent}_len;"
                         )
+                    if rpass == "shaded":
+                        hpp(f"g_ShaderBinaryData.DepthFragmentShaders[{d} - 2][{g}].Code = {fdepth};")
+                        hpp(f"g_ShaderBinaryData.DepthFragmentShaders[{d} - 2][{g}].Count = {fdepth}_len;")
 
         for shader in standalone:
             name = Convoy.to_pascal_case(shader)
@@ -9,7 +9,6 @@ namespace Onyx
 // Basically inherit all aliases from Toolkit
 using namespace TKit::Alias;
 using namespace TKit::Literals;
-using ViewMask = u<ONYX_MAX_VIEWS>;
 using CodePoint = u32;
 
 } // namespace Onyx
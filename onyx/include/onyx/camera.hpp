@@ -21,7 +21,11 @@ struct PerspectiveParameters
 {
     f32 FieldOfView = Math::Radians(75.f);
     f32 Near = 0.1f;
+    // with reversed depth the projection has no far plane, and this only bounds fitted shadow cascades
     f32 Far = 100.f;
+    // maps the near plane to a depth of 1 and an infinitely far plane to 0, which spreads depth precision much more
+    // evenly across large distances
+    bool ReversedDepth = false;
 };
 
 class Window;
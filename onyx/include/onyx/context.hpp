@@ -6,6 +6,7 @@
 #include "onyx/font.hpp"
 #include "onyx/view.hpp"
 #include "onyx/layout.hpp"
+#include "tkit/container/hash_map.hpp"
 
 namespace Onyx
 {
@@ -68,7 +69,9 @@ struct FittedCascadeParameters
 
 struct ShadowCascadeParameters
 {
-    const RenderView<D3> *View = nullptr; // if null, will use fixed cascades. if populated, will use fitted
+    // if null, will use fixed cascades. if populated, will use fitted. fitted cascades only cover the visible depth
+    // range when the view has RenderViewFlag_SampleDistributedShadows
+    const RenderView<D3> *View = nullptr;
     TKit::FixedArray<f32, ONYX_MAX_CASCADES> DepthBias = CreateDepthBias(0.001f, 0.007f);
     FixedCascadeParameters FixedParameters{};
     FittedCascadeParameters FittedParameters{};
@@ -712,6 +715,12 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
         return m_InstanceData;
     }
 
+    // unique clip rects of the instances recorded since the last flush. instances refer to them by their index
+    const TKit::TierArray<WorldRect<D>> &GetClipRects() const
+    {
+        return m_ClipRects;
+    }
+
     const TKit::TierArray<PointLightParameters<D>> &GetPointLightData() const
     {
         return m_PointLightData;
@@ -721,7 +730,7 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
         return m_DirectionalLightData;
     }
 
-    ViewMask GetViewMask() const
+    const ViewMask &GetViewMask() const
     {
         return m_ViewMask;
     }
@@ -735,13 +744,29 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
         return m_Generation > generation;
     }
 
-    void AddTarget(const ViewMask viewMask)
+    // increased whenever a recording of the context differs from the previous one in anything other than the
+    // transforms of its instances. a recording may still shrink its tables without increasing it, so their sizes must
+    // be checked as well
+    u64 GetAttributeGeneration() const
+    {
+        return m_AttributeGeneration;
+    }
+
+    // whether the last recording drew opaque geometry that is not fully opaque, such as an opaque draw with a fill
+    // alpha below one or a faded circle. those leave their alpha in the view's attachment, and only the compositor
+    // blends it over the target
+    bool HasTranslucentOpaqueDraws() const
+    {
+        return m_HasTranslucentOpaqueDraws;
+    }
+
+    void AddTarget(const ViewMask &viewMask)
     {
         m_ViewMask |= viewMask;
         ++m_Generation;
     }
 
-    void RemoveTarget(const ViewMask viewMask)
+    void RemoveTarget(const ViewMask &viewMask)
     {
         m_ViewMask &= ~viewMask;
         ++m_Generation;
@@ -756,6 +781,23 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
         RemoveTarget(view->GetViewBit());
     }
 
+    // static meshes registered with levels of detail pick them from how much they cover of the view with this
+    // projection view matrix. the level is chosen when the mesh is recorded, so every target of the context sees the
+    // same one. without a reference, meshes are always drawn at full resolution
+    void LodReference(const f32m<D> &projectionView)
+    {
+        m_LodProjectionView = projectionView;
+        m_HasLodReference = true;
+    }
+    void LodReference(const RenderView<D> *view)
+    {
+        LodReference(view->GetProjectionView());
+    }
+    void NoLodReference()
+    {
+        m_HasLodReference = false;
+    }
+
     u32 DepthCounter = 0;
 
   protected:
@@ -767,11 +809,20 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
     void resizeInstanceData();
     WorldRect<D> computeWorldRect(const ClipRect<D> &clip);
     ClipRect<D> computeClipRect(const f32v<D> &position, const f32v<D> &dimensions);
+    u32 getClipIndex();
+    u32 getAttributeIndex();
+    void markAttributesChanged()
+    {
+        if (!m_AttributesChanged)
+            ++m_AttributeGeneration;
+        m_AttributesChanged = true;
+    }
 
     template <typename T> void addInstanceData(InstanceDataBuffer &buffer, const T &data);
 
     void addCircleData(const f32m<D> &transform, const CircleParameters &params);
     void addStaticData(Resource mesh, const f32m<D> &transform);
+    Resource selectMeshLod(Resource mesh, const f32m<D> &transform) const;
     void addParametricData(Resource mesh, const f32m<D> &transform, const InstanceParameters &params);
 
     void addGlyphData(TKit::StringView text, const f32m<D> &transform, const ContextTextParameters &params);
@@ -821,11 +872,21 @@ template <Dimension D> class alignas(TKIT_CACHE_LINE_SIZE) IRenderContext
     TKit::TierArray<PointLightParameters<D>> m_PointLightData{};
     TKit::TierArray<DirectionalLightParameters<D>> m_DirectionalLightData{};
     TKit::TierArray<DynamicMeshInfo<D>> m_ImmediateDynamicMeshes{};
+    TKit::TierArray<WorldRect<D>> m_ClipRects{};
+    TKit::TierArray<WorldRect<D>> m_PreviousClipRects{};
+    TKit::TierHashMap<WorldRect<D>, u32> m_ClipIndices{};
 
     u64 m_Generation = 0;
+    u64 m_AttributeGeneration = 0;
+    f32m<D> m_LodProjectionView = f32m<D>::Identity();
     Color m_AmbientLight = Color{Color_White, 0.4f};
-    ViewMask m_ViewMask = 0;
+    ViewMask m_ViewMask{};
     u32 m_DynamicMeshCounter = 0;
+    u32 m_LastClipIndex = ONYX_NULL_CLIP_RECT;
+    u32 m_LastAttributeIndex = TKIT_U32_MAX;
+    bool m_HasLodReference = false;
+    bool m_AttributesChanged = false;
+    bool m_HasTranslucentOpaqueDraws = false;
 };
 
 template <Dimension D> class RenderContext;
@@ -80,6 +80,8 @@ enum ErrorCode : u8
     Error_FileNotFound,
     Error_EntryPointNotFound,
     Error_ShaderCompilationFailed,
+    Error_SaveFailed,
+    Error_UnsupportedFormat,
     Error_Unknown,
     Error_Count
 };
@@ -59,13 +59,32 @@
 #define ONYX_SPOT_LIGHT_NEAR_RANGE_FACTOR 0.05f
 #define ONYX_POINT_LIGHT_NEAR_RADIUS_FACTOR 0.05f
 
+// tiled lighting splits the screen of 3D views in square tiles of this many pixels and lists the point and spot lights
+// reaching each of them. past the per tile maximum, only the lights with the largest screen reach (cull radius over
+// view depth) are kept, ties going to the lowest index. lights whose contribution falls below the cull threshold are
+// considered out of reach
+#define ONYX_LIGHT_TILE_SIZE 16U
+#define ONYX_MAX_LIGHTS_PER_TILE 127U
+#define ONYX_LIGHT_CULL_THRESHOLD (1.f / 256.f)
+// the upper half of the shaded flags holds the attachment index of the view, which selects its light tiles
+#define ONYX_SHADED_FLAGS_ATTACHMENT_SHIFT 16U
+
 // TODO(Isma): These first two interfere with the MAX_*_IDS above. should take minimum of the two
 #define ONYX_MAX_SAMPLERS 8
 #define ONYX_MAX_TEXTURES 96
 #define ONYX_MAX_TEXTURE_MAPS 16
 #define ONYX_MAX_RAY_MARCH_AND_OCCLUSION_MAP_SIZE (2 * ONYX_MAX_TEXTURE_MAPS)
 #define ONYX_MAX_CASCADES 4
-#define ONYX_MAX_VIEWS 32
+// levels of detail a static mesh may have past its full resolution version
+#define ONYX_MAX_MESH_LODS 4
+// clip index of instances that are not clipped
+#define ONYX_NULL_CLIP_RECT 0xFFFFFFFFU
+// view masks hold one bit per view in 32 bit words. it may be any multiple of 32, as long as the shaders are compiled
+// with the same value
+#ifndef ONYX_MAX_VIEWS
+#    define ONYX_MAX_VIEWS 64
+#endif
+#define ONYX_VIEW_MASK_WORDS (ONYX_MAX_VIEWS / 32)
 #define ONYX_MAX_ATTACHMENTS 6
 
 #define ONYX_INSTANCES_BINDING_POINT 0
@@ -87,10 +106,21 @@
 #define ONYX_POINT_MAPS_BINDING_POINT 11
 #define ONYX_DIRECTIONAL_MAPS_BINDING_POINT 12
 #define ONYX_SPOT_MAPS_BINDING_POINT 13
+#define ONYX_CLIP_RECTS_BINDING_POINT 14
+#define ONYX_INSTANCE_ATTRIBUTES_BINDING_POINT 15
 
 #define ONYX_OCCLUSION_MAP_BINDING_POINT 0
 #define ONYX_RAY_MARCH_MAP_BINDING_POINT 1
 
+// light tiles live in a second descriptor set, owned by each view
+#define ONYX_LIGHT_TILES_SET 1
+#define ONYX_LIGHT_TILES_BINDING_POINT 0
+
+// the depth reduction processes square blocks of this many texels per workgroup
+#define ONYX_DEPTH_REDUCE_GROUP_SIZE 16U
+#define ONYX_DEPTH_REDUCE_ATTACHMENTS_BINDING 0
+#define ONYX_DEPTH_REDUCE_RANGES_BINDING 1
+
 #define ONYX_BLEND_TRANSPARENT_ATTACHMENTS_BINDING 0
 #define ONYX_BLEND_REVEALAGE_ATTACHMENTS_BINDING 1
 
@@ -33,6 +33,7 @@ using LoadGltfDataFlags = u8;
 enum LoadGltfDataFlagBit : LoadGltfDataFlags
 {
     LoadGltfDataFlag_ForceRGBA = 1U << 0,
+    LoadGltfDataFlag_OptimizeMeshes = 1U << 1, // runs OptimizeMeshData on every loaded mesh
 };
 template <Dimension D>
 ONYX_NO_DISCARD Result<GltfData<D>> LoadGltfDataFromFile(const std::string &path, LoadGltfDataFlags flags = 0);
@@ -167,5 +167,9 @@ ONYX_NO_DISCARD Result<ImageData> LoadImageDataFromMemory(const std::byte *memor
                                                           ImageComponentFormat requiredComponents = ImageComponent_Auto,
                                                           LoadImageDataFlags flags = 0);
 void UnloadImageData(const ImageData &data);
+
+// only 8-bit formats are supported. the encoding is chosen from the extension of the path (png, bmp, tga or jpg),
+// defaulting to png. bgra formats are swizzled before being written
+ONYX_NO_DISCARD Result<> SaveImageDataToFile(const char *path, const ImageData &data);
 #endif
 } // namespace Onyx
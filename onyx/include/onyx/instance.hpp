@@ -4,6 +4,9 @@
 #include "onyx/handle.hpp"
 #include "onyx/pass.hpp"
 #include "onyx/math.hpp"
+#include "tkit/utils/hash.hpp"
+#include "tkit/math/hash.hpp"
+#include <cstring>
 
 // NOTE(Isma): At some point ill have to handle user wanting to explicitly submit instance data buffers from gpu
 // (without any cpu detours)
@@ -117,11 +120,17 @@ enum Alignment : u8
     Alignment_None = 3,
 };
 
+// rects compare by their bytes, which is how contexts deduplicate their clip tables
 template <Dimension D> struct WorldRect
 {
     f32v<D> Min;
     f32v<D> Edge0;
     f32v<D> Edge1;
+
+    friend bool operator==(const WorldRect &left, const WorldRect &right)
+    {
+        return std::memcmp(&left, &right, sizeof(WorldRect)) == 0;
+    }
 };
 template <> struct WorldRect<D3>
 {
@@ -129,9 +138,30 @@ template <> struct WorldRect<D3>
     f32v3 Edge0;
     f32v3 Edge1;
     f32v3 Edge2;
+
+    friend bool operator==(const WorldRect &left, const WorldRect &right)
+    {
+        return std::memcmp(&left, &right, sizeof(WorldRect)) == 0;
+    }
 };
 
 const char *ToString(Geometry geo);
 const char *ToString(LightType light);
 
 } // namespace Onyx
+
+template <> struct std::hash<Onyx::WorldRect<Onyx::D2>>
+{
+    std::size_t operator()(const Onyx::WorldRect<Onyx::D2> &rect) const
+    {
+        return TKit::Hash(rect.Min, rect.Edge0, rect.Edge1);
+    }
+};
+
+template <> struct std::hash<Onyx::WorldRect<Onyx::D3>>
+{
+    std::size_t operator()(const Onyx::WorldRect<Onyx::D3> &rect) const
+    {
+        return TKit::Hash(rect.Min, rect.Edge0, rect.Edge1, rect.Edge2);
+    }
+};
@@ -60,6 +60,16 @@ struct MeshDataLayout
     u32 IndexCount = 0;
 };
 
+// level of detail chain generated for a static mesh when registering it. each level keeps a fraction of the triangles
+// of the previous one. contexts with a lod reference pick the first level when an instance covers less than the given
+// fraction of the view height, and move one level down every time the coverage halves
+struct MeshLodSpecs
+{
+    u32 Levels = 3; // clamped to ONYX_MAX_MESH_LODS
+    f32 Reduction = 0.5f;
+    f32 Coverage = 0.25f;
+};
+
 enum Topology : u8
 {
     Topology_TriangleList,
@@ -67,9 +77,22 @@ enum Topology : u8
     Topology_TriangleFan,
 };
 
+// reorders the triangles of a triangle list mesh for the post transform vertex cache, then, in 3D, sorts the clusters
+// the new order splits into so that the ones facing outwards are drawn first to cut overdraw. vertices are finally laid
+// out in the order they are first referenced and unreferenced ones are dropped. the mesh looks exactly the same, but is
+// cheaper to draw. worth it for large imported meshes, which are rarely authored in a cache friendly order
+template <typename Vertex> void OptimizeMeshData(MeshData<Vertex> &data);
+
+// simplifies a triangle list mesh by clustering its vertices in a uniform grid, as fine as it can be while keeping at
+// most the given amount of triangles. every cluster collapses into its vertex closest to the cluster average, so
+// attributes are never interpolated. triangles left degenerate or duplicated by the collapse are removed. coarse, but
+// fast and robust enough for distant levels of detail
+template <Dimension D> StaticMeshData<D> SimplifyMeshData(const StaticMeshData<D> &data, u32 maxTriangles);
+
 #ifdef ONYX_ENABLE_OBJ_LOAD
 template <Dimension D>
-ONYX_NO_DISCARD Result<StaticMeshData<D>> LoadStaticMeshDataFromObjFile(const char *path, u32 maxVertices = 2048);
+ONYX_NO_DISCARD Result<StaticMeshData<D>> LoadStaticMeshDataFromObjFile(const char *path, u32 maxVertices = 2048,
+                                                                        bool optimize = false);
 #endif
 
 // TODO(Isma): Triangle is a bit up-shifted. bring it down
@@ -114,7 +137,12 @@ template <typename Vertex> BoundsData<Vertex::Dim> CreateBoundsData(const MeshDa
 {
     constexpr Dimension D = Vertex::Dim;
     BoundsData<D> bounds;
-    bounds.Center = f32v<D>{0.f};
+    // an empty mesh has no extent, so its bounds collapse to the origin instead of dividing by zero below
+    if (data.Vertices.IsEmpty())
+        return bounds;
+
+    bounds.Min = data.Vertices[0].Position;
+    bounds.Max = data.Vertices[0].Position;
     for (const Vertex &vx : data.Vertices)
     {
         bounds.Center += vx.Position;
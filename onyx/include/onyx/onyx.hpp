@@ -15,6 +15,14 @@ enum OpenWindowFlagBit : OpenWindowFlags
     OpenWindowFlag_DoNotDestroyOnQuit = 1U << 1,
     OpenWindowFlag_DoNotDestroyOnShouldClose = 1U << 2,
     OpenWindowFlag_NoDefaultDeltaTime = 1U << 3,
+    // skip acquiring, recording and presenting the window when no event arrived and neither its views nor the
+    // contexts targeting them changed since the last presented frame. edits made directly through a dynamic mesh's
+    // data pointer are not tracked, flush the context or call Resources::Sync() to force a redraw
+    OpenWindowFlag_SkipIdleFrames = 1U << 4,
+    // pace frames against the present timeline instead of sleeping for the target delta time. the next frame starts
+    // just before the vblank it is due for. vblanks are observed when waiting for the image before the last one to be
+    // shown blocks (VK_KHR_present_wait), and extrapolated by whole refresh periods otherwise
+    OpenWindowFlag_PresentPacing = 1U << 5,
 };
 
 using QuitFlags = u8;
@@ -29,6 +37,12 @@ struct OpenWindowSpecs
 {
     WindowSpecs Window = {};
     TKit::Timespan TargetDeltaTime{};
+    // maximum time Running() may block waiting for events when all windows are idle. only used with
+    // OpenWindowFlag_SkipIdleFrames
+    TKit::Timespan IdleTimeout = TKit::Timespan::FromSeconds(0.5f);
+    // extra time reserved on top of the measured frame cost when waking up before a vblank. only used with
+    // OpenWindowFlag_PresentPacing
+    TKit::Timespan PacingSlack = TKit::Timespan::FromSeconds(0.001f);
     OpenWindowFlags Flags = 0;
 #ifdef ONYX_ENABLE_IMGUI
     i32 ImGuiConfigFlags = 0;
@@ -43,6 +57,18 @@ TKit::Timespan GetDeltaTime();
 TKit::Timespan GetDeltaTime(const Window *win);
 TKit::Timespan GetTargetDeltaTime(const Window *win);
 
+struct FrameStats
+{
+    TKit::Timespan Mean{};
+    TKit::Timespan StandardDeviation{};
+    // in squared seconds
+    f32 Variance = 0.f;
+};
+
+// exponentially weighted statistics of the measured frame times of a window. with OpenWindowFlag_PresentPacing, these
+// are the intervals between the vblanks consecutive frames were shown at, as observed or extrapolated when pacing
+FrameStats GetFrameStats(const Window *win);
+
 void SetTargetDeltaTime(Window *win, TKit::Timespan target);
 
 #ifdef ONYX_ENABLE_IMGUI
@@ -65,6 +91,11 @@ void Quit(QuitFlags flags = 0);
 struct TransferInfo
 {
     u32 CoalescePeriod = 1;
+    // coalescing is incremental. each time, at most this many memory ranges are walked, and the walk resumes where the
+    // previous one stopped. zero means no limit
+    u32 CoalesceMaxRanges = 256;
+    // time budget of each coalesce, in microseconds. zero means no limit
+    u32 CoalesceMaxMicroseconds = 0;
 };
 
 struct RenderInfo
@@ -74,4 +105,32 @@ struct RenderInfo
 
 void Transfer(const TransferInfo &info = {});
 void Render(const RenderInfo &info = {});
+
+using OfflineFrameCallback = void (*)(u32 frame, void *userData);
+using OfflineReadbackCallback = void (*)(u32 frame, const Readback &readback, void *userData);
+
+struct OfflineRenderSpecs
+{
+    RenderTexture *Target = nullptr;
+    u32 FrameCount = 0;
+    // maximum amount of frames submitted to the gpu and not yet completed, or whose readback has not been consumed yet
+    u32 FramesInFlight = 3;
+    TransferInfo Transfer{};
+
+    // called on the calling thread before each frame is transferred and recorded. use it to update contexts and cameras
+    OfflineFrameCallback OnFrame = nullptr;
+    // called on a worker thread of the task manager once the pixels of a frame are available. they are only valid for
+    // the duration of the call. if not set, no readbacks are requested
+    OfflineReadbackCallback OnReadback = nullptr;
+    // passed as is to both callbacks
+    void *UserData = nullptr;
+};
+
+/**
+ * @brief Render a sequence of frames into a render texture as fast as the gpu allows.
+ *
+ * No windows are rendered or presented and no pacing is applied. Several frames are kept in flight, and their
+ * readbacks are handed to worker threads so that encoding and writing them to disk overlaps with rendering.
+ */
+void RenderOffline(const OfflineRenderSpecs &specs);
 } // namespace Onyx
@@ -36,7 +36,8 @@ class RenderTarget
     RenderTarget() = default;
     virtual ~RenderTarget();
 
-    template <Dimension D> RenderView<D> *CreateRenderView(Camera<D> *camera, RenderViewFlags flags = 0);
+    template <Dimension D>
+    RenderView<D> *CreateRenderView(Camera<D> *camera, RenderViewFlags flags = 0, SampleCount samples = SampleCount_1);
 
     template <Dimension D> void DestroyRenderView(const RenderView<D> *rv);
 
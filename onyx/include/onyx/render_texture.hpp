@@ -6,6 +6,22 @@
 namespace Onyx
 {
 struct FrontEndImage;
+struct ReadbackBuffer;
+
+using ReadbackTicket = u64;
+constexpr ReadbackTicket NullReadbackTicket = 0;
+
+struct Readback
+{
+    // tightly packed B8G8R8A8 pixels in srgb encoding, row by row
+    const std::byte *Pixels = nullptr;
+    u32v2 Dimensions{0};
+
+    operator bool() const
+    {
+        return Pixels != nullptr;
+    }
+};
 
 class RenderTexture final : public RenderTarget
 {
@@ -15,11 +31,37 @@ class RenderTexture final : public RenderTarget
 
     void FindAvailableImages();
 
-    void BeginRendering(Onyx_CommandBuffer commandBuffer);
+    // if a source image is provided, it is copied into the writable image, which is then loaded instead of cleared
+    void BeginRendering(Onyx_CommandBuffer commandBuffer, VKit::DeviceImage *source = nullptr);
     void EndRendering(Onyx_CommandBuffer commandBuffer);
 
     void MarkWriteImageInUse(const Execution::Tracker &tracker);
     void MarkReadImageInUse(const Execution::Tracker &tracker);
+
+    /**
+     * @brief Request the contents of the next frame rendered into this texture to be copied back to the host.
+     *
+     * The copy is recorded in the render command buffer into a host visible staging buffer and never stalls. Poll the
+     * returned ticket with `GetReadback()` a frame or two later, and release it with `ReleaseReadback()` once the
+     * pixels are no longer needed so that its staging buffer can be reused.
+     *
+     * @return A ticket identifying the readback.
+     */
+    ReadbackTicket RequestReadback();
+
+    /**
+     * @brief Get the pixels of a requested readback.
+     *
+     * @param ticket The ticket returned by `RequestReadback()`.
+     * @return The pixels of the readback, or an empty result if the copy has not completed yet. The pixels remain
+     * valid until the ticket is released.
+     */
+    Readback GetReadback(ReadbackTicket ticket);
+    bool IsReadbackReady(ReadbackTicket ticket) const;
+    // blocks until the copy of a readback completes. the readback must have been recorded already
+    void WaitReadback(ReadbackTicket ticket) const;
+    // the ticket is invalid afterwards. if its copy is still in flight, the staging buffer is reused once it completes
+    void ReleaseReadback(ReadbackTicket ticket);
     const u32v2 &GetDimensions() const
     {
         return m_Dimensions;
@@ -36,6 +78,7 @@ class RenderTexture final : public RenderTarget
     {
         return m_Dimensions;
     }
+    void recordReadbacks(Onyx_CommandBuffer commandBuffer);
 
     Resource m_Handle;
     u32v2 m_Dimensions;
@@ -44,5 +87,7 @@ class RenderTexture final : public RenderTarget
     u32 m_Readable = 0;
 
     TKit::TierArray<FrontEndImage *> m_Images{};
+    TKit::TierArray<ReadbackBuffer *> m_Readbacks{};
+    ReadbackTicket m_ReadbackCount = 0;
 };
 } // namespace Onyx
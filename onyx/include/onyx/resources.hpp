@@ -193,6 +193,9 @@ template <Dimension D> DynamicMeshData<D> *GetDynamicMeshData(Resource mesh);
 template <Dimension D> void DestroyDynamicMesh(Resource mesh);
 
 template <Dimension D> Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D> &data);
+// also registers a level of detail chain for the mesh, sharing its bounds. the levels are not regenerated by UpdateMesh
+template <Dimension D>
+Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D> &data, const MeshLodSpecs &specs);
 template <Dimension D> Resource RegisterMesh(ResourcePool pool, const ParametricMeshData<D> &data);
 template <Dimension D> Resource RegisterMaterial(const MaterialData<D> &data = {});
 
@@ -238,6 +241,8 @@ template <Dimension D> u32 GetDynamicMeshCount();
 
 template <Dimension D> MeshDataLayout GetMeshLayout(Resource mesh);
 template <Dimension D> Resource GetMeshBounds(Resource mesh);
+// the level of detail of a static mesh to draw when it covers the given fraction of the view height
+template <Dimension D> Resource SelectMeshLod(Resource mesh, f32 coverage);
 template <Dimension D> const BoundsData<D> &GetBoundsData(Resource bounds);
 
 u32 GetFontCount(ResourcePool pool);
@@ -40,6 +40,10 @@ struct Specs
     u32 MaxMaterials = 256;
     u32 MaxBounds = 1024;
     u32 MaxDynamicMeshes = 1024;
+    // sub-allocate all static and parametric mesh pools of the same vertex layout from one shared vertex and index
+    // buffer. the renderer then binds those buffers once and draws every pool with a single indirect call per cull
+    // mode, at the cost of uploading all pools of a kind whenever one of them changes
+    bool UnifiedMeshBuffers = false;
 };
 } // namespace Resources
 namespace Descriptors
@@ -87,6 +91,13 @@ struct Specs
 {
     ShadowSpecs<D2> Shadows2{};
     ShadowSpecs<D3> Shadows3{};
+    // store static 3D meshes on the device with 16 bit positions normalized within their bounds, octahedral normals
+    // and tangents and half float texture coordinates. cuts their vertex memory by more than half, at the cost of a
+    // conversion whenever one is registered or updated
+    bool QuantizeStaticMeshes = false;
+    // write instance data and its tables straight into device local memory when the device exposes it to the host,
+    // skipping the staging buffers and the copies from them. has no effect on devices that do not
+    bool DirectInstanceWrites = true;
 };
 
 } // namespace Renderer
@@ -383,6 +383,17 @@ template <> struct Transform<D3> : ITransform<D3>
         projection[3][2] = far * near / (near - far);
         return projection;
     }
+    static f32m4 ReversedPerspective(const f32 fieldOfView, const f32 near, const f32 aspectRatio = 1.f)
+    {
+        f32m4 projection{0.f};
+        const f32 invHalfPov = 1.f / Math::Tangent(0.5f * fieldOfView);
+
+        projection[0][0] = invHalfPov / aspectRatio;
+        projection[1][1] = invHalfPov;
+        projection[2][3] = 1.f;
+        projection[3][2] = near;
+        return projection;
+    }
 };
 
 /**
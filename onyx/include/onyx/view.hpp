@@ -3,12 +3,20 @@
 #include "onyx/core.hpp"
 #include "onyx/camera.hpp"
 #include "onyx/color.hpp"
+#include "onyx/view_mask.hpp"
 #include "tkit/container/tier_array.hpp"
+#include "tkit/profiling/clock.hpp"
 
 ONYX_DECLARE_NON_DISPATCHABLE_VK_HANDLE(DescriptorSet)
 ONYX_DECLARE_NON_DISPATCHABLE_VK_HANDLE(Semaphore)
 ONYX_DECLARE_DISPATCHABLE_VK_HANDLE(CommandBuffer)
 
+namespace VKit
+{
+class DeviceImage;
+class DeviceBuffer;
+}
+
 namespace Onyx::Execution
 {
 struct Tracker;
@@ -33,6 +41,7 @@ template <Dimension D> struct ViewInfo
 {
     f32m4 ProjectionView;
     ViewMask ViewBit;
+    bool ReversedDepth;
 };
 template <> struct ViewInfo<D3>
 {
@@ -40,6 +49,10 @@ template <> struct ViewInfo<D3>
     f32v3 ViewPosition;
     f32v3 ViewForward;
     ViewMask ViewBit;
+    Onyx_DescriptorSet LightTileSet;
+    u32 AttachmentIndex;
+    bool ReversedDepth;
+    bool TiledLighting;
 };
 
 using RenderViewFlags = u16;
@@ -56,6 +69,33 @@ enum RenderViewFlagBit : RenderViewFlags
         RenderViewFlag_NormalizedViewportCoordinates | RenderViewFlag_NormalizedScissorCoordinates,
     RenderViewFlag_DynamicViewport = 1U << 7,
     RenderViewFlag_Hidden = 1U << 8,
+    RenderViewFlag_DynamicResolution = 1U << 9,
+    RenderViewFlag_DepthPrepass = 1U << 10,
+    RenderViewFlag_TiledLighting = 1U << 11,
+    RenderViewFlag_SampleDistributedShadows = 1U << 12,
+};
+
+enum SampleCount : u8
+{
+    SampleCount_1,
+    SampleCount_2,
+    SampleCount_4,
+    SampleCount_8,
+    SampleCount_Count,
+};
+
+/**
+ * @brief Parameters driving the resolution scale of views with `RenderViewFlag_DynamicResolution`.
+ *
+ * The gpu time of the view's opaque, transparent, blend and post process passes is measured every frame. When it
+ * exceeds `TargetTime`, the scale is lowered right away. When there is enough headroom, it slowly climbs back up.
+ * Shadow passes are not accounted for, as their cost does not depend on the view's resolution.
+ */
+struct DynamicResolutionSpecs
+{
+    TKit::Timespan TargetTime = TKit::Timespan::FromSeconds(0.008f);
+    f32 MinScale = 0.5f;
+    f32 MaxScale = 1.f;
 };
 
 struct Framebuffer;
@@ -66,7 +106,7 @@ template <Dimension D> class RenderView
     TKIT_NON_COPYABLE(RenderView)
 
   public:
-    RenderView(const u32v2 &extent, Camera<D> *camera, RenderViewFlags flags = 0);
+    RenderView(const u32v2 &extent, Camera<D> *camera, RenderViewFlags flags = 0, SampleCount samples = SampleCount_1);
     ~RenderView();
 
     // depending on flags, these will expect and return normalized or absolute coordinates!
@@ -116,6 +156,9 @@ template <Dimension D> class RenderView
     void BeginPostProcess(Onyx_CommandBuffer cmd);
     void EndPostProcess(Onyx_CommandBuffer cmd);
 
+    // must be called right after the depth reduction dispatch
+    void EndDepthReduction(Onyx_CommandBuffer cmd);
+
     bool IsWithinViewport(const f32v2 &screenPos) const
     {
         const f32v2 viewportPos = ScreenToViewport(screenPos);
@@ -151,6 +194,14 @@ template <Dimension D> class RenderView
         return m_ProjectionView;
     }
 
+    bool HasReversedDepth() const
+    {
+        if constexpr (D == D2)
+            return false;
+        else
+            return m_Camera->Mode == CameraMode_Perspective && m_Camera->PerspParameters.ReversedDepth;
+    }
+
     RenderViewFlags GetFlags() const
     {
         return m_Flags;
@@ -161,8 +212,14 @@ template <Dimension D> class RenderView
         const RenderViewFlags f = m_Flags;
         m_Flags = flags;
 
-        const RenderViewFlags fbFlags =
-            RenderViewFlag_DynamicViewport | RenderViewFlag_Transparency | RenderViewFlag_PostProcess;
+        if ((f & RenderViewFlag_DynamicResolution) && !(flags & RenderViewFlag_DynamicResolution))
+            m_ResolutionScale = 1.f;
+        if (!(flags & RenderViewFlag_SampleDistributedShadows))
+            m_HasSampledDepthRange = false;
+
+        const RenderViewFlags fbFlags = RenderViewFlag_DynamicViewport | RenderViewFlag_Transparency |
+                                        RenderViewFlag_PostProcess | RenderViewFlag_DynamicResolution |
+                                        RenderViewFlag_TiledLighting | RenderViewFlag_SampleDistributedShadows;
         if ((flags & fbFlags) != (f & fbFlags))
         {
             drainWork();
@@ -178,6 +235,13 @@ template <Dimension D> class RenderView
         SetFlags(m_Flags & ~flags);
     }
 
+    SampleCount GetSampleCount() const
+    {
+        return m_Samples;
+    }
+    // will be clamped to the maximum sample count supported by the device for all attachments
+    void SetSampleCount(SampleCount samples);
+
     void SetView(const f32m<D> &view)
     {
         m_View = view;
@@ -191,7 +255,7 @@ template <Dimension D> class RenderView
         m_ProjectionView = m_Projection * m_View;
     }
 
-    ViewMask GetViewBit() const
+    const ViewMask &GetViewBit() const
     {
         return m_ViewBit;
     }
@@ -303,6 +367,31 @@ template <Dimension D> class RenderView
         return m_ParentExtent;
     }
 
+    // attachments are always allocated with the render extent. when the resolution scale is below 1, only the top left
+    // sub rectangle of this extent is rendered to, and the compositor stretches it back to the view's viewport
+    u32v2 GetScaledRenderExtent() const
+    {
+        const u32v2 extent = GetRenderExtent();
+        if (m_ResolutionScale == 1.f)
+            return extent;
+        return Math::Max(u32v2{f32v2{extent} * m_ResolutionScale}, u32v2{1U});
+    }
+    // maps the [0, 1] texture coordinates of a full pass to the rendered sub rectangle of the attachments
+    f32v2 GetResolutionUvScale() const
+    {
+        return f32v2{GetScaledRenderExtent()} / f32v2{GetRenderExtent()};
+    }
+
+    f32 GetResolutionScale() const
+    {
+        return m_ResolutionScale;
+    }
+    // overriden every frame when `RenderViewFlag_DynamicResolution` is set
+    void SetResolutionScale(const f32 scale)
+    {
+        m_ResolutionScale = Math::Clamp(scale, 0.f, 1.f);
+    }
+
     Camera<D> *GetCamera() const
     {
         return m_Camera;
@@ -326,12 +415,77 @@ template <Dimension D> class RenderView
     {
         return m_CompositorSet;
     }
+    // only allocated for 3D views. the tile buffers are only present with `RenderViewFlag_TiledLighting`
+    Onyx_DescriptorSet GetLightTileSet() const
+    {
+        return m_LightTileSet;
+    }
+
+    // only allocated for 3D views. the depth range buffers are only present with
+    // `RenderViewFlag_SampleDistributedShadows`
+    Onyx_DescriptorSet GetDepthReduceSet() const
+    {
+        return m_DepthReduceSet;
+    }
+
+    /**
+     * @brief Get the ndc depths of the closest and furthest surfaces the view rendered.
+     *
+     * Only available for 3D views with `RenderViewFlag_SampleDistributedShadows`. The range is read back from the
+     * depth reduction of the last frame whose work has completed, so it lags a couple frames behind. Cascades fitted to
+     * this view use it to tighten the frustum they cover. When reversed depth is in use, the near depth is the greater
+     * of the two.
+     *
+     * @param range Receives the range. Left untouched if none is available.
+     * @return Whether a range is available, which is not the case until a frame has completed or when nothing was
+     * rendered.
+     */
+    bool GetSampledDepthRange(f32v2 &range) const
+    {
+        if (m_HasSampledDepthRange)
+            range = m_SampledDepthRange;
+        return m_HasSampledDepthRange;
+    }
+
+    u32v2 GetLightTileCount() const
+    {
+        const u32v2 extent = GetScaledRenderExtent();
+        return (extent + ONYX_LIGHT_TILE_SIZE - 1U) / ONYX_LIGHT_TILE_SIZE;
+    }
 
     u32 GetAttachmentIndex() const
     {
         return m_AttachmentIndex;
     }
 
+    VKit::DeviceImage &GetFinalAttachment();
+    VKit::DeviceBuffer &GetLightTiles();
+
+    // whether anything that affects the output of this view (matrices, viewport, scissor, clear color, layer or flags)
+    // has changed since the last call to MarkRendered()
+    bool HasChanged() const;
+    void MarkRendered();
+
+    /**
+     * @brief Check if the final attachment of this view can be copied as is into its parent's image.
+     *
+     * This is the case when the view covers the whole parent extent at full resolution, its clear color is fully opaque
+     * and it does not need transparency nor post processing. The renderer uses it to skip the compositor pass when a
+     * single view is visible and none of its contexts drew opaque geometry with an alpha below one.
+     */
+    bool CoversParent() const
+    {
+        const RenderViewFlags passFlags =
+            RenderViewFlag_PostProcess | RenderViewFlag_Outlines | RenderViewFlag_Transparency;
+        if ((m_Flags & passFlags) || ClearColor.rgba[3] < 1.f || m_ResolutionScale != 1.f)
+            return false;
+
+        const Viewport vp = GetNormalizedViewport();
+        const Scissor sc = GetNormalizedScissor();
+        return vp.Position == f32v2{0.f} && vp.Extent == f32v2{1.f} && sc.Position == f32v2{0.f} &&
+               sc.Extent == f32v2{1.f} && GetRenderExtent() == m_ParentExtent;
+    }
+
     void ZoomScroll(const f32v<D> &screenPos, f32 step);
 
     ViewInfo<D> CreateViewInfo() const
@@ -344,8 +498,12 @@ template <Dimension D> class RenderView
             info.ProjectionView = m_ProjectionView;
             info.ViewPosition = m_Camera->View.Translation;
             info.ViewForward = Math::Normalize(m_Camera->View.Rotation) * f32v3{0.f, 0.f, -1.f};
+            info.LightTileSet = m_LightTileSet;
+            info.AttachmentIndex = m_AttachmentIndex;
+            info.TiledLighting = m_Flags & RenderViewFlag_TiledLighting;
         }
         info.ViewBit = m_ViewBit;
+        info.ReversedDepth = HasReversedDepth();
         return info;
     }
 
@@ -353,6 +511,7 @@ template <Dimension D> class RenderView
     // TODO(Isma): Think about if its worth it to have a per-instance outline width
     u32 MaxOutlineWidth = 10;
     u64 Layer = 0;
+    DynamicResolutionSpecs DynamicResolution{};
 
   private:
     void findAvailableFramebuffer();
@@ -364,6 +523,16 @@ template <Dimension D> class RenderView
     }
     void drainWork();
 
+    void beginTiming(Onyx_CommandBuffer cmd, u32 query);
+    void endTiming(Onyx_CommandBuffer cmd, u32 query);
+    void updateResolutionScale(Framebuffer *fb);
+    void updateSampledDepthRange(Framebuffer *fb);
+
+    bool reducesDepth() const
+    {
+        return D == D3 && (m_Flags & RenderViewFlag_SampleDistributedShadows);
+    }
+
     Viewport asNormalizedViewport() const
     {
         const f32v2 extent = f32v2{m_ParentExtent};
@@ -401,7 +570,22 @@ template <Dimension D> class RenderView
             recreateFramebuffers();
     }
 
+    struct RenderedState
+    {
+        f32m<D> ProjectionView = f32m<D>::Identity();
+        Viewport ViewportArea{};
+        Scissor ScissorArea{};
+        f32v4 ClearColor{0.f};
+        u32v2 ParentExtent{0};
+        u64 Layer = 0;
+        RenderViewFlags Flags = 0;
+        SampleCount Samples = SampleCount_1;
+        f32 ResolutionScale = 1.f;
+        bool Valid = false;
+    };
+
     Camera<D> *m_Camera;
+    RenderedState m_Rendered{};
     Viewport m_Viewport;
     Scissor m_Scissor;
     ViewMask m_ViewBit;
@@ -415,8 +599,14 @@ template <Dimension D> class RenderView
     Onyx_DescriptorSet m_BlendSet;
     Onyx_DescriptorSet m_PostProcessSet;
     Onyx_DescriptorSet m_CompositorSet;
+    Onyx_DescriptorSet m_LightTileSet;
+    Onyx_DescriptorSet m_DepthReduceSet;
     u32 m_AttachmentIndex = TKIT_U32_MAX;
     RenderViewFlags m_Flags = 0;
+    SampleCount m_Samples = SampleCount_1;
+    f32 m_ResolutionScale = 1.f;
+    f32v2 m_SampledDepthRange{0.f, 1.f};
+    bool m_HasSampledDepthRange = false;
 
     friend class Window;
     friend class RenderTarget;
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "onyx/alias.hpp"
+#include "tkit/container/fixed_array.hpp"
+#include <bit>
+#include <utility>
+
+namespace Onyx
+{
+static_assert(ONYX_MAX_VIEWS % 32 == 0, "[ONYX][VIEW] The maximum amount of views must be a multiple of 32");
+
+// one bit per view. the bits are split in 32 bit words, which is the layout the shaders read them with, so that any
+// amount of views can be used without requiring 64 bit integer support from the device
+struct ViewMask
+{
+    static constexpr u32 WordCount = ONYX_VIEW_MASK_WORDS;
+
+    TKit::FixedArray<u32, WordCount> Words{};
+
+    static ViewMask FromIndex(const u32 index)
+    {
+        ViewMask mask{};
+        mask.Words[index / 32] = 1U << (index % 32);
+        return mask;
+    }
+    static ViewMask All()
+    {
+        return ~ViewMask{};
+    }
+
+    u32 GetCount() const
+    {
+        u32 count = 0;
+        for (const u32 word : Words)
+            count += u32(std::popcount(word));
+        return count;
+    }
+    // amount of views in the mask whose index is lower than the given one
+    u32 GetCountBelow(const u32 index) const
+    {
+        const u32 word = index / 32;
+        u32 count = u32(std::popcount(Words[word] & ((1U << (index % 32)) - 1)));
+        for (u32 i = 0; i < word; ++i)
+            count += u32(std::popcount(Words[i]));
+        return count;
+    }
+    // index of the lowest view in the mask, which must not be empty
+    u32 GetFirstIndex() const
+    {
+        for (u32 i = 0; i < WordCount; ++i)
+            if (Words[i])
+                return 32 * i + u32(std::countr_zero(Words[i]));
+        return ONYX_MAX_VIEWS;
+    }
+    bool Contains(const u32 index) const
+    {
+        return Words[index / 32] & (1U << (index % 32));
+    }
+
+    template <typename F> void ForEach(F &&fun) const
+    {
+        for (u32 i = 0; i < WordCount; ++i)
+            for (u32 word = Words[i]; word; word &= word - 1)
+                std::forward<F>(fun)(32 * i + u32(std::countr_zero(word)));
+    }
+
+    ViewMask operator|(const ViewMask &other) const
+    {
+        ViewMask mask{};
+        for (u32 i = 0; i < WordCount; ++i)
+            mask.Words[i] = Words[i] | other.Words[i];
+        return mask;
+    }
+    ViewMask operator&(const ViewMask &other) const
+    {
+        ViewMask mask{};
+        for (u32 i = 0; i < WordCount; ++i)
+            mask.Words[i] = Words[i] & other.Words[i];
+        return mask;
+    }
+    ViewMask operator~() const
+    {
+        ViewMask mask{};
+        for (u32 i = 0; i < WordCount; ++i)
+            mask.Words[i] = ~Words[i];
+        return mask;
+    }
+    ViewMask &operator|=(const ViewMask &other)
+    {
+        for (u32 i = 0; i < WordCount; ++i)
+            Words[i] |= other.Words[i];
+        return *this;
+    }
+    ViewMask &operator&=(const ViewMask &other)
+    {
+        for (u32 i = 0; i < WordCount; ++i)
+            Words[i] &= other.Words[i];
+        return *this;
+    }
+
+    bool operator==(const ViewMask &other) const
+    {
+        for (u32 i = 0; i < WordCount; ++i)
+            if (Words[i] != other.Words[i])
+                return false;
+        return true;
+    }
+    explicit operator bool() const
+    {
+        for (const u32 word : Words)
+            if (word)
+                return true;
+        return false;
+    }
+};
+} // namespace Onyx
@@ -90,7 +90,8 @@ class Window final : public RenderTarget
 
     void MarkImageSemaphoreInUse(const Execution::Tracker &tracker);
 
-    void BeginRendering(Onyx_CommandBuffer commandBuffer);
+    // if a source image is provided, it is copied into the presentation image, which is then loaded instead of cleared
+    void BeginRendering(Onyx_CommandBuffer commandBuffer, VKit::DeviceImage *source = nullptr);
     void EndRendering(Onyx_CommandBuffer commandBuffer);
 
     bool ShouldClose() const;
@@ -211,6 +212,11 @@ class Window final : public RenderTarget
     bool AcquireNextImage(Timeout timeout);
     void Present();
 
+    // blocks until the image presented before the last one is actually shown on screen. the last one is left alone so
+    // that its gpu work can overlap the next frame. returns false if present wait is not supported, less than two
+    // images have been presented to the current swapchain or the timeout expires
+    bool WaitForPreviousPresent(Timeout timeout);
+
     void RequestSwapchainRecreation()
     {
         m_MustRecreateSwapchain = true;
@@ -272,6 +278,9 @@ class Window final : public RenderTarget
 
     VKit::Queue *m_Present;
 
+    u64 m_PresentId = 0;
+    u64 m_LastPresentId = 0;
+    u64 m_PreviousPresentId = 0;
     u32 m_ImageIndex;
     u32 m_SyncIndex = 0;
     mutable f32v2 m_PrevMousePos{0.f};
@@ -16,6 +16,7 @@ enum BufferType : VKit::DeviceBufferFlags
     Buffer_DeviceVertex = DeviceBufferFlag_Vertex | DeviceBufferFlag_DeviceLocal,
     Buffer_DeviceIndex = DeviceBufferFlag_Index | DeviceBufferFlag_DeviceLocal,
     Buffer_DeviceStorage = DeviceBufferFlag_Storage | DeviceBufferFlag_DeviceLocal,
+    Buffer_DeviceHostStorage = DeviceBufferFlag_Storage | DeviceBufferFlag_DeviceLocal | DeviceBufferFlag_HostMapped,
     Buffer_Staging = DeviceBufferFlag_Staging | DeviceBufferFlag_HostMapped | DeviceBufferFlag_HostRandomAccess,
     Buffer_HostVertex = DeviceBufferFlag_Vertex | DeviceBufferFlag_HostMapped | DeviceBufferFlag_HostRandomAccess,
     Buffer_HostIndex = DeviceBufferFlag_Index | DeviceBufferFlag_HostMapped | DeviceBufferFlag_HostRandomAccess,
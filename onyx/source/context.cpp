@@ -102,9 +102,22 @@ template <Dimension D> void IRenderContext<D>::Flush()
     resizeInstanceData();
     ++m_Generation;
     DepthCounter = 0;
+    m_HasTranslucentOpaqueDraws = false;
     m_DynamicMeshCounter = 0;
     m_PointLightData.Clear();
     m_DirectionalLightData.Clear();
+
+    // the tables of this recording are compared against the ones of the last, so that contexts recording the same
+    // attributes again keep their attribute generation
+    std::swap(m_ClipRects, m_PreviousClipRects);
+    std::swap(m_InstanceData->Attributes, m_InstanceData->PreviousAttributes);
+    m_ClipRects.Clear();
+    m_ClipIndices.Clear();
+    m_InstanceData->Attributes.Clear();
+    m_InstanceData->AttributeIndices.Clear();
+    m_LastClipIndex = ONYX_NULL_CLIP_RECT;
+    m_LastAttributeIndex = TKIT_U32_MAX;
+    m_AttributesChanged = false;
 }
 
 #define CHECK_HANDLE(handle, rtype, dim)                                                                               \
@@ -259,7 +272,7 @@ template <Dimension D> u32 packAlignment(const vec<Alignment, D> alg)
 }
 
 template <Dimension D>
-static void fillInstanceData(InstanceData<D> &instanceData, const ContextState<D> &state, const u32 depthCounter)
+static InstanceAttributes createInstanceAttributes(const ContextState<D> &state, const u32 clipIndex)
 {
 #ifdef TKIT_ENABLE_ENSURE
     checkMaterial<D>(state.Material);
@@ -267,34 +280,42 @@ static void fillInstanceData(InstanceData<D> &instanceData, const ContextState<D
     checkTexture<D>(state.Texture);
 #endif
     const bool flat = state.RenderFlags & RenderModeFlag_Flat;
-    instanceData.Rect = state.Rect;
-    instanceData.MatOrSamplerTex =
+    InstanceAttributes attributes;
+    attributes.ClipIndex = clipIndex;
+    attributes.MatOrSamplerTex =
         flat ? Resources::CombineSamplerTexIntoId(state.Sampler, state.Texture) : GetResourceId(state.Material);
-    instanceData.TexOffset = PackHalf2x16(state.TexOffset);
-    instanceData.TexScale = PackHalf2x16(state.TexScale);
-    instanceData.FillColor = state.FillColor.ToLinear().Pack();
-    instanceData.OutlineColor = state.OutlineColor.ToLinear().Pack();
-    instanceData.OutlineWidth = state.OutlineWidth;
+    attributes.TexOffset = PackHalf2x16(state.TexOffset);
+    attributes.TexScale = PackHalf2x16(state.TexScale);
+    attributes.FillColor = state.FillColor.ToLinear().Pack();
+    attributes.OutlineColor = state.OutlineColor.ToLinear().Pack();
+    attributes.OutlineWidth = state.OutlineWidth;
+    return attributes;
+}
+
+template <Dimension D>
+static void fillInstanceData(InstanceData<D> &instanceData, const u32 attributeIndex, const u32 depthCounter)
+{
+    instanceData.AttributeIndex = attributeIndex;
     if constexpr (D == D2)
         instanceData.DepthCounter = depthCounter;
 }
 
 template <Dimension D>
-static InstanceData<D> createInstanceData(const ContextState<D> &state, const f32m<D> &transform,
-                                          const u32 depthCounter)
+static InstanceData<D> createInstanceData(const f32m<D> &transform, const u32 attributeIndex, const u32 depthCounter)
 {
     InstanceData<D> instanceData;
     instanceData.Transform = PackTransform<D>(transform);
-    fillInstanceData(instanceData, state, depthCounter);
+    fillInstanceData<D>(instanceData, attributeIndex, depthCounter);
     return instanceData;
 }
 
 template <Dimension D>
 static StaticInstanceData<D> createStaticInstanceData(const ContextState<D> &state, const f32m<D> &transform,
-                                                      const Resource bounds, const u32 depthCounter)
+                                                      const Resource bounds, const u32 attributeIndex,
+                                                      const u32 depthCounter)
 {
     StaticInstanceData<D> instanceData;
-    instanceData.Data = createInstanceData(state, transform, depthCounter);
+    instanceData.Data = createInstanceData<D>(transform, attributeIndex, depthCounter);
     instanceData.Alignment = packAlignment<D>(state.Alignment);
     instanceData.BoundsId = GetResourceId(bounds);
     return instanceData;
@@ -302,7 +323,8 @@ static StaticInstanceData<D> createStaticInstanceData(const ContextState<D> &sta
 
 template <Dimension D>
 static CircleInstanceData<D> createCircleInstanceData(const ContextState<D> &state, const f32m<D> &transform,
-                                                      const CircleParameters &params, const u32 depthCounter)
+                                                      const CircleParameters &params, const u32 attributeIndex,
+                                                      const u32 depthCounter)
 {
     // constexpr TKit::FixedArray<f32v2, 9> bounds = {f32v2{-0.5f, -0.5f}, f32v2{-0.5f, 0.f}, f32v2{-0.5f, 0.5f},
     //                                                f32v2{0.f, -0.5f},   f32v2{0.f, 0.f},   f32v2{0.f, 0.5f},
@@ -310,7 +332,7 @@ static CircleInstanceData<D> createCircleInstanceData(const ContextState<D> &sta
     //
     // const f32v2 &alignment = bounds[state.Alignment[0] * 3 + state.Alignment[1]];
     CircleInstanceData<D> instanceData;
-    instanceData.Data = createInstanceData(state, transform, depthCounter);
+    instanceData.Data = createInstanceData<D>(transform, attributeIndex, depthCounter);
     instanceData.Alignment = packAlignment<D>(state.Alignment);
 
     instanceData.Arc.LowerCos = Math::Cosine(params.LowerAngle);
@@ -329,10 +351,11 @@ static CircleInstanceData<D> createCircleInstanceData(const ContextState<D> &sta
 template <Dimension D>
 static ParametricInstanceData<D> createParametricInstanceData(const ContextState<D> &state, const f32m<D> &transform,
                                                               const Resource bounds, const ParametricShape shape,
-                                                              const InstanceParameters &params, const u32 depthCounter)
+                                                              const InstanceParameters &params,
+                                                              const u32 attributeIndex, const u32 depthCounter)
 {
     ParametricInstanceData<D> instanceData;
-    instanceData.Data = createInstanceData(state, transform, depthCounter);
+    instanceData.Data = createInstanceData<D>(transform, attributeIndex, depthCounter);
     instanceData.Alignment = packAlignment<D>(state.Alignment);
     instanceData.BoundsId = GetResourceId(bounds);
     instanceData.Shape = shape;
@@ -350,10 +373,11 @@ static void fillGlyphInstanceData(GlyphInstanceData<D> &instanceData, const Cont
 
 template <Dimension D>
 static GlyphInstanceData<D> createGlyphInstanceData(const ContextState<D> &state, const f32m<D> &transform,
-                                                    const f32 unitRange, const u32 depthCounter)
+                                                    const f32 unitRange, const u32 attributeIndex,
+                                                    const u32 depthCounter)
 {
     GlyphInstanceData<D> instanceData;
-    instanceData.Data = createInstanceData(state, transform, depthCounter);
+    instanceData.Data = createInstanceData<D>(transform, attributeIndex, depthCounter);
     fillGlyphInstanceData(instanceData, state, unitRange);
     return instanceData;
 }
@@ -491,6 +515,60 @@ ClipRect<D> IRenderContext<D>::computeClipRect(const f32v<D> &position, const f3
     return ClipRect<D>{mn, mx};
 }
 
+// consecutive instances almost always share the clip rect, so the last one used is checked first. otherwise the rect
+// is looked up in the table before appending it
+template <Dimension D> u32 IRenderContext<D>::getClipIndex()
+{
+    const WorldRect<D> &rect = m_State.Rect;
+    if (rect.Min[0] == TKIT_F32_MIN)
+        return ONYX_NULL_CLIP_RECT;
+
+    if (m_LastClipIndex != ONYX_NULL_CLIP_RECT && m_ClipRects[m_LastClipIndex] == rect)
+        return m_LastClipIndex;
+
+    const auto it = m_ClipIndices.Find(rect);
+    if (it != m_ClipIndices.end())
+    {
+        m_LastClipIndex = it->Value;
+        return m_LastClipIndex;
+    }
+
+    m_LastClipIndex = m_ClipRects.GetSize();
+    if (m_LastClipIndex >= m_PreviousClipRects.GetSize() || !(m_PreviousClipRects[m_LastClipIndex] == rect))
+        markAttributesChanged();
+
+    m_ClipRects.Append(rect);
+    m_ClipIndices.Insert(rect, m_LastClipIndex);
+    return m_LastClipIndex;
+}
+
+template <Dimension D> u32 IRenderContext<D>::getAttributeIndex()
+{
+    if (m_State.Blend == BlendPass_Opaque && m_State.FillColor.rgba[3] < 1.f)
+        m_HasTranslucentOpaqueDraws = true;
+
+    const InstanceAttributes attributes = createInstanceAttributes(m_State, getClipIndex());
+    TKit::TierArray<InstanceAttributes> &table = m_InstanceData->Attributes;
+    if (m_LastAttributeIndex != TKIT_U32_MAX && table[m_LastAttributeIndex] == attributes)
+        return m_LastAttributeIndex;
+
+    const auto it = m_InstanceData->AttributeIndices.Find(attributes);
+    if (it != m_InstanceData->AttributeIndices.end())
+    {
+        m_LastAttributeIndex = it->Value;
+        return m_LastAttributeIndex;
+    }
+
+    m_LastAttributeIndex = table.GetSize();
+    const TKit::TierArray<InstanceAttributes> &previous = m_InstanceData->PreviousAttributes;
+    if (m_LastAttributeIndex >= previous.GetSize() || !(previous[m_LastAttributeIndex] == attributes))
+        markAttributesChanged();
+
+    table.Append(attributes);
+    m_InstanceData->AttributeIndices.Insert(attributes, m_LastAttributeIndex);
+    return m_LastAttributeIndex;
+}
+
 template <Dimension D>
 template <typename T>
 void IRenderContext<D>::addInstanceData(InstanceDataBuffer &buffer, const T &data)
@@ -504,7 +582,11 @@ template <Dimension D> void IRenderContext<D>::addCircleData(const f32m<D> &tran
 {
     if (!m_State.RenderFlags)
         return;
-    const CircleInstanceData<D> idata = createCircleInstanceData(m_State, transform, params, ++DepthCounter);
+    if (m_State.Blend == BlendPass_Opaque && (params.InnerFade > 0.f || params.OuterFade > 0.f))
+        m_HasTranslucentOpaqueDraws = true;
+
+    const CircleInstanceData<D> idata =
+        createCircleInstanceData(m_State, transform, params, getAttributeIndex(), ++DepthCounter);
     InstanceDataBuffer &buffer = m_InstanceData->Circles[m_State.Blend][GetRenderMode(m_State.RenderFlags)];
     addInstanceData(buffer, idata);
 }
@@ -515,11 +597,12 @@ template <Dimension D> void IRenderContext<D>::addStaticData(const Resource mesh
         return;
     CHECK_HANDLE(mesh, Resource_StaticMesh, D);
 
-    const u32 pid = GetResourcePoolId(mesh);
-    const u32 mid = GetResourceId(mesh);
+    const Resource lod = m_HasLodReference ? selectMeshLod(mesh, transform) : mesh;
+    const u32 pid = GetResourcePoolId(lod);
+    const u32 mid = GetResourceId(lod);
 
-    const StaticInstanceData<D> idata =
-        createStaticInstanceData(m_State, transform, Resources::GetMeshBounds<D>(mesh), ++DepthCounter);
+    const StaticInstanceData<D> idata = createStaticInstanceData(m_State, transform, Resources::GetMeshBounds<D>(mesh),
+                                                                 getAttributeIndex(), ++DepthCounter);
 
     InstanceResourceGroup &group =
         m_InstanceData->Meshes[m_State.Blend][GetRenderMode(m_State.RenderFlags)][Resource_StaticMesh][pid];
@@ -527,6 +610,31 @@ template <Dimension D> void IRenderContext<D>::addStaticData(const Resource mesh
     group.Registry.RegisterResourceId(mid);
     addInstanceData(group.Buffers[mid], idata);
 }
+
+// the coverage is the projected radius of the bounding sphere over the half height of the view in normalized device
+// coordinates. the length of the second row of the projection view matrix is the scale of that projection, whether it
+// is perspective or orthographic
+template <Dimension D>
+Resource IRenderContext<D>::selectMeshLod(const Resource mesh, const f32m<D> &transform) const
+{
+    const BoundsData<D> &bounds = Resources::GetBoundsData<D>(Resources::GetMeshBounds<D>(mesh));
+    const f32v<D + 1> center = transform * f32v<D + 1>{0.5f * (bounds.Min + bounds.Max), 1.f};
+    const f32v<D + 1> clip = m_LodProjectionView * center;
+    const f32 w = clip[D];
+    if (w <= 0.f)
+        return mesh;
+
+    f32 scale = 0.f;
+    f32v<D> row;
+    for (u32 i = 0; i < D; ++i)
+    {
+        scale = Math::Max(scale, Math::Norm(f32v<D>{transform[i]}));
+        row[i] = m_LodProjectionView[i][1];
+    }
+    const f32 radius = 0.5f * Math::Norm(bounds.Max - bounds.Min) * scale;
+    return Resources::SelectMeshLod<D>(mesh, radius * Math::Norm(row) / w);
+}
+
 template <Dimension D> void IRenderContext<D>::addDynamicData(const Resource mesh, const f32m<D> &transform)
 {
     if (!m_State.RenderFlags)
@@ -535,7 +643,7 @@ template <Dimension D> void IRenderContext<D>::addDynamicData(const Resource mes
     ONYX_CHECK_RESOURCE_IS_VALID_WITH_DIM(mesh, Resource_DynamicMesh, D);
 
     const u32 mid = GetResourceId(mesh);
-    const DynamicInstanceData<D> idata = createInstanceData(m_State, transform, ++DepthCounter);
+    const DynamicInstanceData<D> idata = createInstanceData<D>(transform, getAttributeIndex(), ++DepthCounter);
 
     InstanceResourceGroup &group = m_InstanceData->DynamicMeshes[m_State.Blend][GetRenderMode(m_State.RenderFlags)];
     group.Registry.RegisterResourceId(mid);
@@ -555,7 +663,7 @@ void IRenderContext<D>::addParametricData(const Resource mesh, const f32m<D> &tr
     const ParametricShape shape = Resources::GetParametricShape<D>(mesh);
 
     const ParametricInstanceData<D> idata = createParametricInstanceData(
-        m_State, transform, Resources::GetMeshBounds<D>(mesh), shape, params, ++DepthCounter);
+        m_State, transform, Resources::GetMeshBounds<D>(mesh), shape, params, getAttributeIndex(), ++DepthCounter);
 
     InstanceResourceGroup &group =
         m_InstanceData->Meshes[m_State.Blend][GetRenderMode(m_State.RenderFlags)][Resource_ParametricMesh][pid];
@@ -669,7 +777,7 @@ void IRenderContext<D>::addGlyphData(TKit::StringView text, const f32m<D> &trans
 
     GlyphInstanceData<D> instanceData;
     instanceData.Data.Transform = PackTransform<D>(transform);
-    fillInstanceData(instanceData.Data, m_State, DepthCounter);
+    fillInstanceData<D>(instanceData.Data, getAttributeIndex(), DepthCounter);
     fillGlyphInstanceData(instanceData, m_State, fdata.UnitRange);
 
     PackedTransform<D> &t = instanceData.Data.Transform;
@@ -709,7 +817,8 @@ void IRenderContext<D>::addGlyphData(TKit::StringView text, const f32m<D> &trans
 template <Dimension D>
 void IRenderContext<D>::addGlyphData(const Resource glyph, const f32 unitRange, const f32m<D> &transform)
 {
-    const GlyphInstanceData<D> idata = createGlyphInstanceData(m_State, transform, unitRange, DepthCounter);
+    const GlyphInstanceData<D> idata =
+        createGlyphInstanceData(m_State, transform, unitRange, getAttributeIndex(), DepthCounter);
 
     const u32 pid = GetResourcePoolId(glyph);
     const u32 gid = GetResourceId(glyph);
@@ -660,6 +660,10 @@ const char *ToString(const ErrorCode code)
         return "EntryPointNotFound";
     case Error_ShaderCompilationFailed:
         return "ShaderCompilationFailed";
+    case Error_SaveFailed:
+        return "SaveFailed";
+    case Error_UnsupportedFormat:
+        return "UnsupportedFormat";
     default:
         return "Unknown";
     }
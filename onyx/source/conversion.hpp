@@ -33,6 +33,10 @@ constexpr VkRect2D AsVulkanScissor(const Scissor &sc)
     const u32v2 ext = u32v2{sc.Extent};
     return {{pos[0], pos[1]}, {ext[0], ext[1]}};
 }
+constexpr VkSampleCountFlagBits AsVulkanSampleCount(const SampleCount samples)
+{
+    return VkSampleCountFlagBits(1U << samples);
+}
 constexpr RenderPass GetRenderPass(const PipelinePass mode)
 {
     switch (mode)
@@ -46,6 +46,8 @@ static TKit::Storage<VKit::LogicalDevice> s_Device{};
 static TKit::Storage<VKit::DeletionQueue> s_DeletionQueue{};
 
 static VmaAllocator s_VulkanAllocator = VK_NULL_HANDLE;
+static bool s_PresentWait = false;
+static bool s_DeviceLocalHostVisible = false;
 static const char *s_DumpPath;
 
 #define PUSH_DELETER(code) s_DeletionQueue->Push([=] { code; })
@@ -96,6 +98,8 @@ static void createDevice(const InitializationFlags flags)
         .RequireExtension("VK_KHR_image_format_list")
         .RequireExtension("VK_EXT_descriptor_indexing")
         .RequireExtension("VK_EXT_extended_dynamic_state")
+        .RequestExtension("VK_KHR_present_id")
+        .RequestExtension("VK_KHR_present_wait")
         .RequireApiVersion(1, 2, 0)
         .RequestApiVersion(1, 4, 0);
     if (flags & InitializationFlag_EnableDeviceFaultExtension)
@@ -146,6 +150,33 @@ static void createDevice(const InitializationFlags flags)
         s_Physical->EnableExtensionBoundFeature(&faultFeatures);
     }
 
+    // used for frame pacing. if not available, the timeline semaphores are used as a fallback
+    VkPhysicalDevicePresentIdFeaturesKHR presentId{};
+    presentId.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWait{};
+    presentWait.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    if (s_Physical->IsExtensionEnabled("VK_KHR_present_id") && s_Physical->IsExtensionEnabled("VK_KHR_present_wait"))
+    {
+        presentId.pNext = &presentWait;
+
+        const auto table = GetInstanceTable();
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &presentId;
+        table->GetPhysicalDeviceFeatures2KHR(*s_Physical, &features2);
+
+        s_PresentWait = presentId.presentId && presentWait.presentWait;
+        if (s_PresentWait)
+        {
+            presentId.pNext = nullptr;
+            presentWait.pNext = nullptr;
+            s_Physical->EnableExtensionBoundFeature(&presentId);
+            s_Physical->EnableExtensionBoundFeature(&presentWait);
+        }
+    }
+    TKIT_LOG_INFO_IF(!s_PresentWait, "[ONYX][CORE] Present wait is not supported. Frame pacing will fall back to "
+                                     "timeline semaphore completion timestamps");
+
     VkPhysicalDeviceShaderDrawParameterFeatures drawParams{};
     drawParams.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES;
 
@@ -158,6 +189,8 @@ static void createDevice(const InitializationFlags flags)
     features.Core.drawIndirectFirstInstance = VK_TRUE;
     features.Core.multiDrawIndirect = VK_TRUE;
     features.Vulkan11.shaderDrawParameters = VK_TRUE;
+    // point light shadows render the six cube faces in a single pass
+    features.Vulkan11.multiview = VK_TRUE;
     features.Vulkan12.timelineSemaphore = VK_TRUE;
     features.Vulkan12.descriptorBindingPartiallyBound = VK_TRUE;
     features.Vulkan12.runtimeDescriptorArray = VK_TRUE;
@@ -216,6 +249,30 @@ static void createVulkanAllocator()
     s_VulkanAllocator = ONYX_CHECK_VKIT_RESULT(VKit::CreateAllocator(*s_Device));
 
     PUSH_DELETER(VKit::DestroyAllocator(s_VulkanAllocator));
+
+    // integrated devices share their memory with the host. discrete devices only expose all of their memory to the host
+    // with resizable bar enabled, otherwise the host visible device local heap is a small 256 MiB window
+    constexpr VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    constexpr VkDeviceSize barWindow = 256 * 1024 * 1024;
+
+    const bool integrated = s_Physical->GetInfo().Properties.Core.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU;
+    const VkPhysicalDeviceMemoryProperties *memory;
+    vmaGetMemoryProperties(s_VulkanAllocator, &memory);
+    for (u32 i = 0; i < memory->memoryTypeCount; ++i)
+    {
+        const VkMemoryType &type = memory->memoryTypes[i];
+        if ((type.propertyFlags & required) == required &&
+            (integrated || memory->memoryHeaps[type.heapIndex].size > barWindow))
+        {
+            s_DeviceLocalHostVisible = true;
+            break;
+        }
+    }
+    TKIT_LOG_INFO_IF(s_DeviceLocalHostVisible,
+                     "[ONYX][CORE] The device exposes its local memory to the host. Instance data will be written to "
+                     "it directly");
 }
 
 static void createInstance(InitializationFlags flags)
@@ -421,6 +478,14 @@ bool IsDebugUtilsEnabled()
 {
     return s_Instance->IsExtensionEnabled("VK_EXT_debug_utils");
 }
+bool IsPresentWaitSupported()
+{
+    return s_PresentWait;
+}
+bool IsDeviceLocalHostVisible()
+{
+    return s_DeviceLocalHostVisible;
+}
 void DeviceWaitIdle()
 {
     TKIT_BEGIN_DEBUG_CLOCK();
@@ -51,6 +51,11 @@ const VKit::Vulkan::DeviceTable *GetDeviceTable();
 const VKit::PhysicalDevice &GetPhysicalDevice();
 
 bool IsDebugUtilsEnabled();
+// whether both VK_KHR_present_id and VK_KHR_present_wait are enabled along with their features
+bool IsPresentWaitSupported();
+// whether the device local memory of the device is fully visible to the host, either because the device is integrated
+// or because resizable bar is enabled
+bool IsDeviceLocalHostVisible();
 
 void DeviceWaitIdle();
 
@@ -54,8 +54,13 @@ static void createDescriptorData(const Specs &specs)
     constexpr u32 directionalMaps = ONYX_DIRECTIONAL_MAPS_BINDING_POINT;
     constexpr u32 spotMaps = ONYX_SPOT_MAPS_BINDING_POINT;
     constexpr u32 spotLights = ONYX_SPOT_LIGHTS_BINDING_POINT;
+    constexpr u32 clipRects = ONYX_CLIP_RECTS_BINDING_POINT;
+    constexpr u32 attributes = ONYX_INSTANCE_ATTRIBUTES_BINDING_POINT;
     constexpr u32 occlusionMap = ONYX_OCCLUSION_MAP_BINDING_POINT;
     constexpr u32 rayMarchMap = ONYX_RAY_MARCH_MAP_BINDING_POINT;
+    constexpr u32 lightTiles = ONYX_LIGHT_TILES_BINDING_POINT;
+    constexpr u32 depthReduceAttachments = ONYX_DEPTH_REDUCE_ATTACHMENTS_BINDING;
+    constexpr u32 depthReduceRanges = ONYX_DEPTH_REDUCE_RANGES_BINDING;
     constexpr u32 blendTransparentAttachments = ONYX_BLEND_TRANSPARENT_ATTACHMENTS_BINDING;
     constexpr u32 blendRevealageAttachments = ONYX_BLEND_REVEALAGE_ATTACHMENTS_BINDING;
     constexpr u32 postProcessColorAttachments = ONYX_POST_PROCESS_COLOR_ATTACHMENTS_BINDING;
@@ -81,7 +86,9 @@ static void createDescriptorData(const Specs &specs)
         .AddBinding2(samplers, sampler, fragment, ONYX_MAX_SAMPLERS, pbound | bindUnused)
         .AddBinding2(textures, sampledImage, fragment, ONYX_MAX_TEXTURES, pbound | bindUnused)
         .AddBinding2(textureOffsets, buffer, fragment)
-        .AddBinding2(bounds, buffer, vertex);
+        .AddBinding2(bounds, buffer, vertex)
+        .AddBinding2(clipRects, buffer, fragment)
+        .AddBinding2(attributes, buffer, fragment);
 
     s_DescriptorData->Layouts[Dim2][RenderPass_Flat] = ONYX_CHECK_VKIT_RESULT(flatLayout.Build());
     s_DescriptorData->Layouts[Dim3][RenderPass_Flat] = ONYX_CHECK_VKIT_RESULT(flatLayout.Build());
@@ -92,8 +99,10 @@ static void createDescriptorData(const Specs &specs)
         .AddBinding2(textures, sampledImage, fragment, ONYX_MAX_TEXTURES, pbound | bindUnused)
         .AddBinding2(textureOffsets, buffer, fragment)
         .AddBinding2(bounds, buffer, vertex)
+        .AddBinding2(clipRects, buffer, fragment)
+        .AddBinding2(attributes, buffer, fragment)
         .AddBinding2(materials, buffer, fragment)
-        .AddBinding2(pointLights, buffer, fragment)
+        .AddBinding2(pointLights, buffer, fragment | compute)
         .AddBinding2(directionalLights, buffer, fragment)
         .AddBinding2(shadowSampler, sampler, fragment)
         .AddBinding2(shadowCompareSampler, sampler, fragment);
@@ -109,14 +118,16 @@ static void createDescriptorData(const Specs &specs)
         shadedLayout.AddBinding2(pointMaps, sampledImage, fragment, ONYX_MAX_TEXTURE_MAPS, pbound | bindUnused)
             .AddBinding2(directionalMaps, sampledImage, fragment, ONYX_MAX_TEXTURE_MAPS, pbound | bindUnused)
             .AddBinding2(spotMaps, sampledImage, fragment, ONYX_MAX_TEXTURE_MAPS, pbound | bindUnused)
-            .AddBinding2(spotLights, buffer, fragment)
+            .AddBinding2(spotLights, buffer, fragment | compute)
             .Build());
 
     VKit::DescriptorSetLayout::Builder shadowLayout{device};
     shadowLayout.AddBinding2(instances, buffer, vertex | fragment)
         .AddBinding2(samplers, sampler, fragment, ONYX_MAX_SAMPLERS, pbound | bindUnused)
         .AddBinding2(textures, sampledImage, fragment, ONYX_MAX_TEXTURES, pbound | bindUnused)
-        .AddBinding2(bounds, buffer, vertex);
+        .AddBinding2(bounds, buffer, vertex)
+        .AddBinding2(clipRects, buffer, fragment)
+        .AddBinding2(attributes, buffer, fragment);
 
     s_DescriptorData->Layouts[Dim3][RenderPass_Shadow] = ONYX_CHECK_VKIT_RESULT(shadowLayout.Build());
 
@@ -130,6 +141,19 @@ static void createDescriptorData(const Specs &specs)
             .AddBinding2(rayMarchMap, storageImage, compute, ONYX_MAX_RAY_MARCH_AND_OCCLUSION_MAP_SIZE, pbound)
             .Build());
 
+    // the light cull pass writes the light tiles of a view, which the shaded 3D pass then reads. the lights themselves
+    // are read straight from the 3D shaded set
+    s_DescriptorData->StandaloneLayouts[StandalonePass_LightCull] = ONYX_CHECK_VKIT_RESULT(
+        VKit::DescriptorSetLayout::Builder(device)
+            .AddBinding2(lightTiles, buffer, compute | fragment, ONYX_MAX_ATTACHMENTS, pbound)
+            .Build());
+
+    s_DescriptorData->StandaloneLayouts[StandalonePass_DepthReduce] = ONYX_CHECK_VKIT_RESULT(
+        VKit::DescriptorSetLayout::Builder(device)
+            .AddBinding2(depthReduceAttachments, sampledImage, compute, ONYX_MAX_ATTACHMENTS, pbound)
+            .AddBinding2(depthReduceRanges, buffer, compute, ONYX_MAX_ATTACHMENTS, pbound)
+            .Build());
+
     s_DescriptorData->StandaloneLayouts[StandalonePass_Blend] = ONYX_CHECK_VKIT_RESULT(
         VKit::DescriptorSetLayout::Builder(device)
             .AddBinding2(blendTransparentAttachments, combined, fragment, ONYX_MAX_ATTACHMENTS, pbound)
@@ -159,6 +183,10 @@ static void createDescriptorData(const Specs &specs)
 
         ONYX_CHECK_VKIT_RESULT(s_DescriptorData->StandaloneLayouts[StandalonePass_RayMarch].SetName(
             "onyx-ray-march-descriptor-set-layout"));
+        ONYX_CHECK_VKIT_RESULT(s_DescriptorData->StandaloneLayouts[StandalonePass_LightCull].SetName(
+            "onyx-light-cull-descriptor-set-layout"));
+        ONYX_CHECK_VKIT_RESULT(s_DescriptorData->StandaloneLayouts[StandalonePass_DepthReduce].SetName(
+            "onyx-depth-reduce-descriptor-set-layout"));
         ONYX_CHECK_VKIT_RESULT(
             s_DescriptorData->StandaloneLayouts[StandalonePass_Blend].SetName("onyx-blend-descriptor-set-layout"));
         ONYX_CHECK_VKIT_RESULT(s_DescriptorData->StandaloneLayouts[StandalonePass_PostProcess].SetName(
@@ -149,6 +149,8 @@ template <Dimension D> Result<GltfData<D>> LoadGltfDataFromFile(const std::strin
                     break;
                 }
             }
+            if (flags & LoadGltfDataFlag_OptimizeMeshes)
+                OptimizeMeshData(meshData);
             data.StaticMeshes.Append(meshData);
         }
     }
@@ -4,6 +4,7 @@
 #include "vkit/resource/device_image.hpp"
 #ifdef ONYX_ENABLE_IMAGE_LOAD
 #    include <stb_image.h>
+#    include <stb_image_write.h>
 #endif
 
 namespace Onyx
@@ -201,5 +202,67 @@ void UnloadImageData(const ImageData &data)
 {
     TKit::Deallocate(data.Data);
 }
+
+static bool isBGRA(const Format format)
+{
+    switch (format)
+    {
+    case Format_B8G8R8A8_UNORM:
+    case Format_B8G8R8A8_SNORM:
+    case Format_B8G8R8A8_UINT:
+    case Format_B8G8R8A8_SINT:
+    case Format_B8G8R8A8_SRGB:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Result<> SaveImageDataToFile(const char *path, const ImageData &data)
+{
+    const usz size = data.ComputeSize();
+    if (size != usz(data.Width) * data.Height * data.Components || data.Components == 0 || data.Components > 4)
+        return Result<>::Error(Error_UnsupportedFormat,
+                               "[ONYX][IMAGE] Only 8-bit formats with 1 to 4 components can be saved");
+
+    const std::byte *pixels = data.Data;
+    std::byte *swizzled = nullptr;
+    if (isBGRA(data.Format))
+    {
+        swizzled = scast<std::byte *>(TKit::Allocate(size));
+        TKIT_ASSERT(swizzled, "[ONYX][IMAGE] Failed to allocate image data with size {:L} bytes", size);
+        for (usz i = 0; i < size; i += 4)
+        {
+            swizzled[i] = data.Data[i + 2];
+            swizzled[i + 1] = data.Data[i + 1];
+            swizzled[i + 2] = data.Data[i];
+            swizzled[i + 3] = data.Data[i + 3];
+        }
+        pixels = swizzled;
+    }
+
+    const std::string_view p = path;
+    const i32 w = i32(data.Width);
+    const i32 h = i32(data.Height);
+    const i32 c = i32(data.Components);
+
+    i32 result;
+    if (p.ends_with(".bmp"))
+        result = stbi_write_bmp(path, w, h, c, pixels);
+    else if (p.ends_with(".tga"))
+        result = stbi_write_tga(path, w, h, c, pixels);
+    else if (p.ends_with(".jpg") || p.ends_with(".jpeg"))
+        result = stbi_write_jpg(path, w, h, c, pixels, 95);
+    else
+        result = stbi_write_png(path, w, h, c, pixels, w * c);
+
+    if (swizzled)
+        TKit::Deallocate(swizzled);
+
+    if (!result)
+        return Result<>::Error(Error_SaveFailed,
+                               TKit::TierString::Format("[ONYX][IMAGE] Failed to save image data to '{}'", path));
+    return Result<>::Ok();
+}
 #endif
 } // namespace Onyx
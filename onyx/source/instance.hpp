@@ -3,9 +3,12 @@
 #include "onyx/instance.hpp"
 #include "onyx/math.hpp"
 #include "onyx/handle.hpp"
+#include "onyx/view_mask.hpp"
 #include "onyx/resources.hpp"
 #include "vkit/resource/host_buffer.hpp"
 #include "tkit/container/bitset.hpp"
+#include "tkit/container/hash_map.hpp"
+#include "tkit/utils/hash.hpp"
 
 namespace Onyx
 {
@@ -30,29 +33,39 @@ template <Dimension D> PackedTransform<D> PackTransform(const f32m<D> &transform
     return data;
 }
 
-// having world rect per instance is a bit painful. bloats instance data a lot, but i really could not find a better
-// alternative due to how contexts are designed to be independent and its data being read only once recorded
-template <Dimension D> struct InstanceData
+// instance data is split in two streams. the per instance stream holds the transform and the index of the attributes
+// of the instance, which live in a deduplicated table of their context. contexts whose instances only moved since their
+// last upload keep their attribute table in place and only transfer the per instance stream. the renderer rebases the
+// indices when uploading so that they point into the shared buffers
+struct InstanceAttributes
 {
-    PackedTransform<D> Transform;
-    WorldRect<D> Rect;
+    // index into the clip table of the context, or ONYX_NULL_CLIP_RECT if not clipped
+    u32 ClipIndex;
     u32 FillColor;
     u32 OutlineColor;
     u32 MatOrSamplerTex;
     u32 TexOffset;
     u32 TexScale;
     f32 OutlineWidth;
+
+    friend bool operator==(const InstanceAttributes &left, const InstanceAttributes &right)
+    {
+        return left.ClipIndex == right.ClipIndex && left.FillColor == right.FillColor &&
+               left.OutlineColor == right.OutlineColor && left.MatOrSamplerTex == right.MatOrSamplerTex &&
+               left.TexOffset == right.TexOffset && left.TexScale == right.TexScale &&
+               left.OutlineWidth == right.OutlineWidth;
+    }
+};
+
+template <Dimension D> struct InstanceData
+{
+    PackedTransform<D> Transform;
+    u32 AttributeIndex;
 };
 template <> struct InstanceData<D2>
 {
     PackedTransform<D2> Transform;
-    WorldRect<D2> Rect;
-    u32 FillColor;
-    u32 OutlineColor;
-    u32 MatOrSamplerTex;
-    u32 TexOffset;
-    u32 TexScale;
-    f32 OutlineWidth;
+    u32 AttributeIndex;
     u32 DepthCounter;
 };
 
@@ -212,8 +225,15 @@ using ShadedFlags = u32;
 enum ShadedFlagBit : ShadedFlags
 {
     ShadedFlag_Shadows = 1U << 0,
+    ShadedFlag_TiledLighting = 1U << 1,
+    ShadedFlag_ReversedDepth = 1U << 2,
 };
 
+// the shaded flags baked into the shaded pipelines through a specialization constant. they occupy the lowest bits, so
+// that masking the flags of a view yields the index of the pipeline variant it needs
+constexpr ShadedFlags ShadedFlag_Specialized = ShadedFlag_Shadows | ShadedFlag_TiledLighting;
+constexpr u32 ShadedVariant_Count = ShadedFlag_Specialized + 1;
+
 template <> struct ShadedPushConstantData<D2>
 {
     f32m4 ProjectionView;
@@ -221,7 +241,7 @@ template <> struct ShadedPushConstantData<D2>
     TKit::FixedArray<f32, LightTypeCount<D2>> TexelSizes{};
     u32 AmbientColor;
     ShadedFlags Flags;
-    ViewMask ViewBit;
+    u32 ViewIndex;
 };
 
 template <> struct ShadedPushConstantData<D3>
@@ -233,16 +253,37 @@ template <> struct ShadedPushConstantData<D3>
     TKit::FixedArray<f32, LightTypeCount<D3>> TexelSizes{};
     u32 AmbientColor;
     ShadedFlags Flags;
-    ViewMask ViewBit;
+    u32 ViewIndex;
+};
+
+using FlatFlags = u32;
+enum FlatFlagBit : FlatFlags
+{
+    FlatFlag_ReversedDepth = 1U << 0,
 };
 
-using FlatPushConstantData = f32m4;
-using CompositorPushConstantData = u32;
-using BlendPushConstantData = u32;
+struct FlatPushConstantData
+{
+    f32m4 ProjectionView;
+    FlatFlags Flags;
+};
+
+// uv scales map full pass texture coordinates to the rendered sub rectangle of views with a resolution scale below 1
+struct CompositorPushConstantData
+{
+    f32v2 UvScale;
+    u32 AttachmentIndex;
+};
+struct BlendPushConstantData
+{
+    f32v2 UvScale;
+    u32 AttachmentIndex;
+};
 
 struct PostProcessPushConstantData
 {
     u32v2 Extent;
+    f32v2 UvScale;
     u32 AttachmentIndex;
     u32 MaxOutlineWidth;
     u32 Flags;
@@ -275,6 +316,24 @@ struct RayMarchPushConstantData
     f32 DistanceBias;
 };
 
+struct LightCullPushConstantData
+{
+    f32m4 ProjectionView;
+    u32v2 Extent;
+    u32 PointRange;
+    u32 SpotRange;
+    u32 TileCountX;
+    u32 AttachmentIndex;
+    u32 ViewIndex;
+};
+
+struct DepthReducePushConstantData
+{
+    u32v2 Extent;
+    u32 AttachmentIndex;
+    u32 ReversedDepth;
+};
+
 struct InstanceDataBuffer
 {
     VKit::HostBuffer Data{};
@@ -317,6 +376,11 @@ struct ContextInstanceData
     ten<InstanceResourceGroup, BlendPass_Count, RenderMode_Count> DynamicMeshes{};
     ten<InstanceResourceGroup, BlendPass_Count, RenderMode_Count, Resource_MeshPoolCount, ONYX_MAX_RESOURCE_POOLS>
         Meshes{};
+
+    // the attributes of the previous recording are kept to tell whether the current one changed them
+    TKit::TierArray<InstanceAttributes> Attributes{};
+    TKit::TierArray<InstanceAttributes> PreviousAttributes{};
+    TKit::TierHashMap<InstanceAttributes, u32> AttributeIndices{};
 };
 
 template <Dimension D, typename F> void ForEachResourceGroup(F &&func)
@@ -331,3 +395,13 @@ template <Dimension D, typename F> void ForEachResourceGroup(F &&func)
 }
 
 } // namespace Onyx
+
+template <> struct std::hash<Onyx::InstanceAttributes>
+{
+    std::size_t operator()(const Onyx::InstanceAttributes &attributes) const
+    {
+        return TKit::Hash(attributes.ClipIndex, attributes.FillColor, attributes.OutlineColor,
+                          attributes.MatOrSamplerTex, attributes.TexOffset, attributes.TexScale,
+                          attributes.OutlineWidth);
+    }
+};
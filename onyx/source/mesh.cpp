@@ -2,6 +2,7 @@
 #include "onyx/mesh.hpp"
 #include "tkit/container/stack_array.hpp"
 #include "tkit/container/hash_map.hpp"
+#include "tkit/container/static_array.hpp"
 #ifdef ONYX_ENABLE_OBJ_LOAD
 #    include <tiny_obj_loader.h>
 #endif
@@ -52,9 +53,429 @@ template <typename Vertex> static void validateMeshData(MeshData<Vertex> &data,
 #else
 #    define VALIDATE_MESH_DATA(...) tidyMeshData(__VA_ARGS__)
 #endif
+// tuning of the vertex cache optimization, following Tom Forsyth's "Linear-Speed Vertex Cache Optimisation". the
+// cache is larger than the one of any real hardware so that the result degrades gracefully on all of them
+static constexpr u32 s_OptimizerCacheSize = 32;
+static constexpr f32 s_OptimizerCacheDecayPower = 1.5f;
+static constexpr f32 s_OptimizerLastTriangleScore = 0.75f;
+static constexpr f32 s_OptimizerValenceBoostScale = 2.f;
+static constexpr f32 s_OptimizerValenceBoostPower = 0.5f;
+// size of the fifo cache simulated to find where the optimized order starts over, splitting it into clusters that can
+// be freely reordered for overdraw without hurting the cache
+static constexpr u32 s_OverdrawCacheSize = 16;
+
+static f32 computeVertexScore(const u32 cachePosition, const u32 remaining)
+{
+    if (remaining == 0)
+        return -1.f;
+
+    f32 score = 0.f;
+    if (cachePosition < 3)
+        score = s_OptimizerLastTriangleScore;
+    else if (cachePosition < s_OptimizerCacheSize)
+    {
+        const f32 scaler = 1.f / f32(s_OptimizerCacheSize - 3);
+        score = Math::Power(1.f - f32(cachePosition - 3) * scaler, s_OptimizerCacheDecayPower);
+    }
+    return score + s_OptimizerValenceBoostScale * Math::Power(f32(remaining), -s_OptimizerValenceBoostPower);
+}
+
+static void optimizeVertexCache(TKit::DynamicArray<Index> &indices, const u32 vertexCount)
+{
+    constexpr u32 notCached = TKit::Limits<u32>::Max();
+    const u32 triangleCount = indices.GetSize() / 3;
+
+    // triangles referencing each vertex, packed by vertex. the first remaining[v] entries of a range are the ones not
+    // emitted yet
+    TKit::DynamicArray<u32> remaining{};
+    TKit::DynamicArray<u32> offsets{};
+    TKit::DynamicArray<u32> adjacency{};
+    remaining.Resize(vertexCount, 0);
+    offsets.Resize(vertexCount, 0);
+    adjacency.Resize(indices.GetSize());
+
+    for (const Index idx : indices)
+        ++remaining[idx];
+    for (u32 v = 1; v < vertexCount; ++v)
+        offsets[v] = offsets[v - 1] + remaining[v - 1];
+
+    TKit::DynamicArray<u32> fill{};
+    fill.Resize(vertexCount, 0);
+    for (u32 i = 0; i < indices.GetSize(); ++i)
+    {
+        const Index idx = indices[i];
+        adjacency[offsets[idx] + fill[idx]++] = i / 3;
+    }
+
+    TKit::DynamicArray<u32> cachePositions{};
+    TKit::DynamicArray<f32> vertexScores{};
+    cachePositions.Resize(vertexCount, notCached);
+    vertexScores.Resize(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v)
+        vertexScores[v] = computeVertexScore(notCached, remaining[v]);
+
+    TKit::DynamicArray<u8> emitted{};
+    emitted.Resize(triangleCount, 0);
+
+    TKit::DynamicArray<Index> output{};
+    output.Reserve(indices.GetSize());
+
+    TKit::StaticArray<Index, s_OptimizerCacheSize + 3> cache{};
+    TKit::StaticArray<Index, s_OptimizerCacheSize + 3> nextCache{};
+
+    u32 best = notCached;
+    u32 cursor = 0;
+    for (u32 count = 0; count < triangleCount; ++count)
+    {
+        // nothing in the cache is adjacent to a pending triangle. start over from the next one in authored order
+        if (best == notCached)
+        {
+            while (emitted[cursor])
+                ++cursor;
+            best = cursor;
+        }
+
+        emitted[best] = 1;
+        nextCache.Clear();
+        for (u32 i = 0; i < 3; ++i)
+        {
+            const Index idx = indices[3 * best + i];
+            output.Append(idx);
+            nextCache.Append(idx);
+
+            // swap the triangle out of the pending part of the adjacency range of the vertex
+            const u32 start = offsets[idx];
+            const u32 last = start + --remaining[idx];
+            for (u32 j = start; j <= last; ++j)
+                if (adjacency[j] == best)
+                {
+                    std::swap(adjacency[j], adjacency[last]);
+                    break;
+                }
+        }
+
+        for (const Index idx : cache)
+            if (idx != indices[3 * best] && idx != indices[3 * best + 1] && idx != indices[3 * best + 2])
+                nextCache.Append(idx);
+
+        for (u32 i = 0; i < nextCache.GetSize(); ++i)
+        {
+            const Index idx = nextCache[i];
+            cachePositions[idx] = i < s_OptimizerCacheSize ? i : notCached;
+            vertexScores[idx] = computeVertexScore(cachePositions[idx], remaining[idx]);
+        }
+
+        best = notCached;
+        f32 bestScore = -1.f;
+        for (const Index idx : nextCache)
+            for (u32 j = offsets[idx]; j < offsets[idx] + remaining[idx]; ++j)
+            {
+                const u32 t = adjacency[j];
+                const f32 score = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] +
+                                  vertexScores[indices[3 * t + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+
+        cache.Clear();
+        for (u32 i = 0; i < nextCache.GetSize() && i < s_OptimizerCacheSize; ++i)
+            cache.Append(nextCache[i]);
+    }
+
+    indices = output;
+}
+
+template <typename Vertex> static void optimizeOverdraw(MeshData<Vertex> &data)
+{
+    TKit::DynamicArray<Index> &indices = data.Indices;
+    const u32 triangleCount = indices.GetSize() / 3;
+
+    // a cluster starts wherever the cache order misses all three vertices of a triangle
+    TKit::DynamicArray<u32> clusters{};
+    TKit::DynamicArray<u32> timestamps{};
+    timestamps.Resize(data.Vertices.GetSize(), 0);
+    u32 time = s_OverdrawCacheSize + 1;
+    for (u32 t = 0; t < triangleCount; ++t)
+    {
+        u32 misses = 0;
+        for (u32 i = 0; i < 3; ++i)
+        {
+            const Index idx = indices[3 * t + i];
+            if (time - timestamps[idx] > s_OverdrawCacheSize)
+            {
+                timestamps[idx] = time++;
+                ++misses;
+            }
+        }
+        if (misses == 3)
+            clusters.Append(t);
+    }
+    if (clusters.GetSize() < 2)
+        return;
+
+    struct ClusterInfo
+    {
+        f32v3 Centroid;
+        f32v3 Normal;
+        f32 Area;
+        f32 Sort;
+    };
+    TKit::DynamicArray<ClusterInfo> infos{};
+    infos.Resize(clusters.GetSize());
+
+    f32v3 meshCentroid{0.f};
+    f32 meshArea = 0.f;
+    for (u32 c = 0; c < clusters.GetSize(); ++c)
+    {
+        const u32 end = c + 1 < clusters.GetSize() ? clusters[c + 1] : triangleCount;
+        ClusterInfo &info = infos[c];
+        info.Centroid = f32v3{0.f};
+        info.Normal = f32v3{0.f};
+        info.Area = 0.f;
+        for (u32 t = clusters[c]; t < end; ++t)
+        {
+            const f32v3 &p0 = data.Vertices[indices[3 * t]].Position;
+            const f32v3 &p1 = data.Vertices[indices[3 * t + 1]].Position;
+            const f32v3 &p2 = data.Vertices[indices[3 * t + 2]].Position;
+
+            const f32v3 normal = Math::Cross(p1 - p0, p2 - p0);
+            const f32 area = Math::Norm(normal);
+            info.Centroid += area * (p0 + p1 + p2) / 3.f;
+            info.Normal += normal;
+            info.Area += area;
+        }
+        meshCentroid += info.Centroid;
+        meshArea += info.Area;
+        if (!Math::ApproachesZero(info.Area))
+            info.Centroid /= info.Area;
+    }
+    if (Math::ApproachesZero(meshArea))
+        return;
+    meshCentroid /= meshArea;
+
+    // clusters facing away from the center are the likeliest to occlude the rest, so they are drawn first
+    TKit::DynamicArray<u32> order{};
+    order.Resize(clusters.GetSize());
+    for (u32 c = 0; c < clusters.GetSize(); ++c)
+    {
+        ClusterInfo &info = infos[c];
+        const f32 norm = Math::Norm(info.Normal);
+        info.Sort = Math::ApproachesZero(norm) ? 0.f : Math::Dot(info.Centroid - meshCentroid, info.Normal) / norm;
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&infos](const u32 left, const u32 right) { return infos[left].Sort > infos[right].Sort; });
+
+    TKit::DynamicArray<Index> output{};
+    output.Reserve(indices.GetSize());
+    for (const u32 c : order)
+    {
+        const u32 end = c + 1 < clusters.GetSize() ? clusters[c + 1] : triangleCount;
+        output.Insert(output.end(), indices.begin() + 3 * clusters[c], indices.begin() + 3 * end);
+    }
+    indices = output;
+}
+
+// vertices are renumbered in the order they are first referenced, dropping the ones no triangle uses
+template <typename Vertex> static void optimizeVertexFetch(MeshData<Vertex> &data)
+{
+    constexpr Index unused = TKit::Limits<Index>::Max();
+    TKit::DynamicArray<Index> remap{};
+    remap.Resize(data.Vertices.GetSize(), unused);
+
+    TKit::DynamicArray<Vertex> vertices{};
+    vertices.Reserve(data.Vertices.GetSize());
+    for (Index &idx : data.Indices)
+    {
+        if (remap[idx] == unused)
+        {
+            remap[idx] = Index(vertices.GetSize());
+            vertices.Append(data.Vertices[idx]);
+        }
+        idx = remap[idx];
+    }
+    data.Vertices = vertices;
+}
+
+template <typename Vertex> void OptimizeMeshData(MeshData<Vertex> &data)
+{
+    if (data.Indices.GetSize() < 3 || data.Indices.GetSize() % 3 != 0)
+        return;
+
+    optimizeVertexCache(data.Indices, data.Vertices.GetSize());
+    if constexpr (Vertex::Dim == D3)
+        optimizeOverdraw(data);
+    optimizeVertexFetch(data);
+}
+
+static constexpr u32 s_MaxClusterResolution = 1024;
+
+struct VertexClusters
+{
+    TKit::DynamicArray<u64> Keys{};
+    TKit::DynamicArray<u32> Order{};
+    // cluster of every vertex, numbered in key order
+    TKit::DynamicArray<u32> Ids{};
+    u32 Count = 0;
+};
+
+template <Dimension D>
+static void clusterVertices(const StaticMeshData<D> &data, const BoundsData<D> &bounds, const u32 resolution,
+                            VertexClusters &clusters)
+{
+    f32 extent = 0.f;
+    for (u32 i = 0; i < D; ++i)
+        extent = Math::Max(extent, bounds.Max[i] - bounds.Min[i]);
+    const f32 cellSize = Math::ApproachesZero(extent) ? 1.f : extent / f32(resolution);
+
+    const u32 vcount = data.Vertices.GetSize();
+    for (u32 v = 0; v < vcount; ++v)
+    {
+        u64 key = 0;
+        for (u32 i = D - 1; i < D; --i)
+        {
+            const u32 cell = u32((data.Vertices[v].Position[i] - bounds.Min[i]) / cellSize);
+            key = key * resolution + Math::Min(cell, resolution - 1);
+        }
+        clusters.Keys[v] = key;
+        clusters.Order[v] = v;
+    }
+    std::sort(clusters.Order.begin(), clusters.Order.end(),
+              [&clusters](const u32 left, const u32 right) { return clusters.Keys[left] < clusters.Keys[right]; });
+
+    clusters.Count = 0;
+    for (u32 i = 0; i < vcount; ++i)
+    {
+        const u32 v = clusters.Order[i];
+        if (i != 0 && clusters.Keys[v] != clusters.Keys[clusters.Order[i - 1]])
+            ++clusters.Count;
+        clusters.Ids[v] = clusters.Count;
+    }
+    ++clusters.Count;
+}
+
+struct ClusteredTriangle
+{
+    u32 Clusters[3];
+    u32 Triangle;
+};
+
+static bool operator<(const ClusteredTriangle &left, const ClusteredTriangle &right)
+{
+    for (u32 i = 0; i < 3; ++i)
+        if (left.Clusters[i] != right.Clusters[i])
+            return left.Clusters[i] < right.Clusters[i];
+    return left.Triangle < right.Triangle;
+}
+
+// collapses every triangle onto the clusters of its corners. degenerate results are dropped, and of those that end up
+// on the same clusters with the same winding only the first is kept. survivors stay in their original order
+static void collapseTriangles(const TKit::DynamicArray<Index> &indices, const VertexClusters &clusters,
+                              TKit::DynamicArray<ClusteredTriangle> &triangles)
+{
+    triangles.Clear();
+    for (u32 i = 0; i < indices.GetSize(); i += 3)
+    {
+        const u32 c[3] = {clusters.Ids[indices[i]], clusters.Ids[indices[i + 1]], clusters.Ids[indices[i + 2]]};
+        if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2])
+            continue;
+
+        // rotating the smallest cluster first keeps the winding while making equal triangles compare equal
+        const u32 first = c[0] < c[1] ? (c[0] < c[2] ? 0 : 2) : (c[1] < c[2] ? 1 : 2);
+        triangles.Append(ClusteredTriangle{{c[first], c[(first + 1) % 3], c[(first + 2) % 3]}, i / 3});
+    }
+    std::sort(triangles.begin(), triangles.end());
+
+    u32 count = 0;
+    for (u32 i = 0; i < triangles.GetSize(); ++i)
+    {
+        const ClusteredTriangle &tri = triangles[i];
+        if (count != 0 && std::equal(tri.Clusters, tri.Clusters + 3, triangles[count - 1].Clusters))
+            continue;
+        triangles[count++] = tri;
+    }
+    triangles.Resize(count);
+    std::sort(triangles.begin(), triangles.end(),
+              [](const ClusteredTriangle &left, const ClusteredTriangle &right) {
+                  return left.Triangle < right.Triangle;
+              });
+}
+
+template <Dimension D> StaticMeshData<D> SimplifyMeshData(const StaticMeshData<D> &data, const u32 maxTriangles)
+{
+    const u32 icount = data.Indices.GetSize();
+    if (icount % 3 != 0 || icount / 3 <= maxTriangles)
+        return data;
+
+    const u32 vcount = data.Vertices.GetSize();
+    const BoundsData<D> bounds = CreateBoundsData(data);
+
+    VertexClusters clusters{};
+    TKit::DynamicArray<ClusteredTriangle> triangles{};
+    clusters.Keys.Resize(vcount);
+    clusters.Order.Resize(vcount);
+    clusters.Ids.Resize(vcount);
+
+    // finer grids keep more triangles, so the finest one within budget is searched for. a single cell keeps none
+    u32 lo = 1;
+    u32 hi = s_MaxClusterResolution;
+    while (lo < hi)
+    {
+        const u32 mid = (lo + hi + 1) / 2;
+        clusterVertices(data, bounds, mid, clusters);
+        collapseTriangles(data.Indices, clusters, triangles);
+        if (triangles.GetSize() <= maxTriangles)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    clusterVertices(data, bounds, lo, clusters);
+    collapseTriangles(data.Indices, clusters, triangles);
+
+    TKit::DynamicArray<f32v<D>> centers{};
+    TKit::DynamicArray<u32> counts{};
+    centers.Resize(clusters.Count, f32v<D>{0.f});
+    counts.Resize(clusters.Count, 0);
+    for (u32 v = 0; v < vcount; ++v)
+    {
+        centers[clusters.Ids[v]] += data.Vertices[v].Position;
+        ++counts[clusters.Ids[v]];
+    }
+
+    constexpr Index unassigned = TKit::Limits<Index>::Max();
+    TKit::DynamicArray<Index> representatives{};
+    TKit::DynamicArray<f32> distances{};
+    representatives.Resize(clusters.Count, unassigned);
+    distances.Resize(clusters.Count, TKIT_F32_MAX);
+    for (u32 v = 0; v < vcount; ++v)
+    {
+        const u32 c = clusters.Ids[v];
+        const f32v<D> diff = data.Vertices[v].Position - centers[c] / f32(counts[c]);
+        const f32 distance = Math::Dot(diff, diff);
+        if (distance < distances[c])
+        {
+            distances[c] = distance;
+            representatives[c] = Index(v);
+        }
+    }
+
+    StaticMeshData<D> simplified{};
+    simplified.Vertices = data.Vertices;
+    simplified.Flags = data.Flags;
+    for (const ClusteredTriangle &tri : triangles)
+        for (u32 i = 0; i < 3; ++i)
+            simplified.Indices.Append(representatives[tri.Clusters[i]]);
+    optimizeVertexFetch(simplified);
+    return simplified;
+}
+
 #ifdef ONYX_ENABLE_OBJ_LOAD
 
-template <Dimension D> Result<StaticMeshData<D>> LoadStaticMeshDataFromObjFile(const char *path, const u32 maxVertices)
+template <Dimension D>
+Result<StaticMeshData<D>> LoadStaticMeshDataFromObjFile(const char *path, const u32 maxVertices, const bool optimize)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -95,6 +516,8 @@ template <Dimension D> Result<StaticMeshData<D>> LoadStaticMeshDataFromObjFile(c
             }
             data.Indices.Append(uniqueVertices[vertex]);
         }
+    if (optimize)
+        OptimizeMeshData(data);
     return data;
 }
 #endif
@@ -1675,8 +2098,18 @@ template ParametricMeshData<D3> CreateStadiumMeshData<D3>();
 template ParametricMeshData<D2> CreateRoundedRectMeshData<D2>();
 template ParametricMeshData<D3> CreateRoundedRectMeshData<D3>();
 
+template void OptimizeMeshData(StaticMeshData<D2> &data);
+template void OptimizeMeshData(StaticMeshData<D3> &data);
+template void OptimizeMeshData(ParametricMeshData<D2> &data);
+template void OptimizeMeshData(ParametricMeshData<D3> &data);
+
+template StaticMeshData<D2> SimplifyMeshData(const StaticMeshData<D2> &data, u32 maxTriangles);
+template StaticMeshData<D3> SimplifyMeshData(const StaticMeshData<D3> &data, u32 maxTriangles);
+
 #ifdef ONYX_ENABLE_OBJ_LOAD
-template Result<StaticMeshData<D2>> LoadStaticMeshDataFromObjFile<D2>(const char *path, u32 maxVertices);
-template Result<StaticMeshData<D3>> LoadStaticMeshDataFromObjFile<D3>(const char *path, u32 maxVertices);
+template Result<StaticMeshData<D2>> LoadStaticMeshDataFromObjFile<D2>(const char *path, u32 maxVertices,
+                                                                      bool optimize);
+template Result<StaticMeshData<D3>> LoadStaticMeshDataFromObjFile<D3>(const char *path, u32 maxVertices,
+                                                                      bool optimize);
 #endif
 } // namespace Onyx
@@ -1,6 +1,7 @@
 #include "pch.hpp"
 #include "onyx/onyx.hpp"
 #include "onyx/overlay.hpp"
+#include "core.hpp"
 #include "platform.hpp"
 #include "renderer.hpp"
 #include "resources.hpp"
@@ -32,16 +33,109 @@ struct WindowData
 #endif
     OpenWindowFlags Flags = 0;
 
-    bool IsDue() const
+    // idle frame tracking, only used with OpenWindowFlag_SkipIdleFrames
+    TKit::Timespan IdleTimeout{};
+    u64 ViewGeneration = 0;
+    u32 ViewCount = 0;
+    f32v4 ClearColor{0.f};
+    // a couple of extra frames are rendered after a change so that one frame delayed state (such as imgui's) settles
+    static constexpr u32 IdleSettleFrames = 3;
+    u32 ActiveFrames = IdleSettleFrames;
+    bool Idle = false;
+
+    // present pacing, only used with OpenWindowFlag_PresentPacing. timestamps are relative to the api time clock
+    TKit::Timespan PacingSlack{};
+    TKit::Timespan FrameStart{};
+    TKit::Timespan LastVBlank{};
+    TKit::Timespan FrameCost{};
+    bool HasVBlank = false;
+    bool Presented = false;
+
+    FrameStats Stats{};
+
+    bool IsPaced() const
     {
+        return Flags & OpenWindowFlag_PresentPacing;
+    }
+    TKit::Timespan GetPacingPeriod() const
+    {
+        return DeltaTarget > TKit::Timespan{} ? DeltaTarget : Window->GetMonitorDeltaTime();
+    }
+    // the next frame must be ready for the vblank following the last one, so it starts its measured cost earlier
+    TKit::Timespan GetNextFrameStart() const
+    {
+        return LastVBlank + GetPacingPeriod() - FrameCost - PacingSlack;
+    }
+
+    bool IsDue(const TKit::Timespan now) const
+    {
+        if (IsPaced())
+            return !HasVBlank || now >= GetNextFrameStart();
         return Clock.GetElapsed() >= DeltaTarget - DeltaError;
     }
+    TKit::Timespan ComputeSleep(const TKit::Timespan now) const
+    {
+        if (IsPaced())
+            return HasVBlank ? GetNextFrameStart() - now : TKit::Timespan{};
+        return DeltaTarget - Clock.GetElapsed() - DeltaError;
+    }
+
+    void AddFrameSample(const TKit::Timespan frameTime)
+    {
+        const f32 alpha = 0.05f;
+        const f32 sample = frameTime.AsSeconds();
+        const f32 mean = Stats.Mean.AsSeconds();
+        const f32 diff = sample - mean;
+
+        Stats.Mean = TKit::Timespan::FromSeconds(mean + alpha * diff);
+        Stats.Variance = (1.f - alpha) * (Stats.Variance + alpha * diff * diff);
+        Stats.StandardDeviation = TKit::Timespan::FromSeconds(Math::SquareRoot(Stats.Variance));
+    }
+
     void MarkTick()
     {
         DeltaTime = Clock.Restart();
         const f32 smoothness = 0.5f;
         const TKit::Timespan error = DeltaTime - DeltaTarget;
         DeltaError = smoothness * DeltaError + (1.f - smoothness) * error;
+        if (!IsPaced())
+            AddFrameSample(DeltaTime);
+    }
+    // after an idle period, the elapsed time is meaningless and would otherwise leak into the delta time
+    void MarkWake()
+    {
+        Clock.Restart();
+        DeltaTime = DeltaTarget;
+        DeltaError = TKit::Timespan{};
+        HasVBlank = false;
+        Idle = false;
+    }
+    // the gpu work of a frame overlaps the next one, so only the cpu cost up to its submission must fit before the
+    // vblank
+    void MarkSubmitted(const TKit::Timespan now)
+    {
+        const f32 smoothness = 0.9f;
+        FrameCost = smoothness * FrameCost + (1.f - smoothness) * (now - FrameStart);
+        Presented = true;
+    }
+    // the last vblank at or before the given time, extrapolated from the last one known in whole periods
+    TKit::Timespan PredictVBlank(const TKit::Timespan now) const
+    {
+        if (!HasVBlank)
+            return now;
+
+        const TKit::Timespan period = GetPacingPeriod();
+        const TKit::Timespan vblank = LastVBlank + period;
+        if (now <= vblank)
+            return vblank;
+        return vblank + f32(u32((now - vblank).AsSeconds() / period.AsSeconds())) * period;
+    }
+    void MarkPresented(const TKit::Timespan vblank)
+    {
+        if (HasVBlank)
+            AddFrameSample(vblank - LastVBlank);
+        LastVBlank = vblank;
+        HasVBlank = true;
     }
 };
 
@@ -58,6 +152,8 @@ struct ApiData
     TKit::Clock FrameClock{};
     TKit::Clock TimeClock{};
     TKit::Timespan DeltaTime{};
+    u64 RenderTextureGeneration = 0;
+    u64 ResourceGeneration = 0;
     QuitFlags Quit = 0;
 };
 
@@ -138,6 +234,10 @@ TKit::Timespan GetTargetDeltaTime(const Window *win)
 {
     return s_Data->Windows[getWindowIndex(win)].DeltaTarget;
 }
+FrameStats GetFrameStats(const Window *win)
+{
+    return s_Data->Windows[getWindowIndex(win)].Stats;
+}
 void SetTargetDeltaTime(Window *win, const TKit::Timespan target)
 {
     s_Data->Windows[getWindowIndex(win)].DeltaTarget = target;
@@ -168,6 +268,8 @@ Window *OpenWindow(const OpenWindowSpecs &specs)
 #endif
 
     wdata.Flags = specs.Flags;
+    wdata.IdleTimeout = specs.IdleTimeout;
+    wdata.PacingSlack = specs.PacingSlack;
     if (specs.Window.PresentMode == PresentMode_Immediate && !(specs.Flags & OpenWindowFlag_NoDefaultDeltaTime))
         wdata.DeltaTarget = wdata.Window->GetMonitorDeltaTime();
     else
@@ -277,10 +379,30 @@ void DestroyRenderTexture(const RenderTexture *rtex)
                "CreateRenderTexture() function");
 }
 
+static bool areAllWindowsIdle(TKit::Timespan &timeout)
+{
+    if (s_Data->Windows.IsEmpty() || !s_Data->RenderTextures.IsEmpty())
+        return false;
+
+    timeout = s_Data->Windows[0].IdleTimeout;
+    for (const WindowData &wdata : s_Data->Windows)
+    {
+        if (!wdata.Idle)
+            return false;
+        if (wdata.IdleTimeout < timeout)
+            timeout = wdata.IdleTimeout;
+    }
+    return true;
+}
+
 bool Running()
 {
     // a bit weird to have it here, but it works
-    Platform::PollEvents();
+    TKit::Timespan timeout{};
+    if (areAllWindowsIdle(timeout))
+        Platform::WaitEvents(timeout);
+    else
+        Platform::PollEvents();
     //
     if (s_Data->Quit & QuitFlag_Quit)
     {
@@ -312,7 +434,7 @@ void Transfer(const TransferInfo &info)
 
     static u64 transferCount = 0;
     if (info.CoalescePeriod != 0 && (transferCount++ % info.CoalescePeriod) == 0)
-        Renderer::Coalesce();
+        Renderer::Coalesce({.MaxRanges = info.CoalesceMaxRanges, .MaxMicroseconds = info.CoalesceMaxMicroseconds});
 
     VKit::Queue *tqueue = Execution::GetQueue(VKit::Queue_Transfer);
     CommandPool *tpool = Execution::FindAvailableCommandPool(VKit::Queue_Transfer);
@@ -325,6 +447,90 @@ void Transfer(const TransferInfo &info)
     if (tinfo)
         Renderer::SubmitTransfer(tqueue, tpool, tinfo);
 }
+template <Dimension D> static bool haveViewsChanged(const RenderTarget *target, ViewMask &vmask)
+{
+    bool changed = false;
+    for (const RenderView<D> *rv : target->GetRenderViews<D>())
+    {
+        vmask |= rv->GetViewBit();
+        changed |= rv->HasChanged();
+    }
+    return changed;
+}
+static void markViewsRendered(const RenderTarget *target)
+{
+    for (RenderView<D2> *rv : target->GetRenderViews<D2>())
+        rv->MarkRendered();
+    for (RenderView<D3> *rv : target->GetRenderViews<D3>())
+        rv->MarkRendered();
+}
+
+// windows may sample render textures, so any change in them must be treated as a change in every window
+static bool haveRenderTexturesChanged()
+{
+    ViewMask vmask{};
+    bool changed = false;
+    for (const RenderTexture *rtex : s_Data->RenderTextures)
+    {
+        changed |= haveViewsChanged<D2>(rtex, vmask);
+        changed |= haveViewsChanged<D3>(rtex, vmask);
+    }
+    const u64 generation = Renderer::GetViewGeneration(vmask);
+    changed |= generation != s_Data->RenderTextureGeneration;
+    s_Data->RenderTextureGeneration = generation;
+    return changed;
+}
+
+// resources are shared by every context, so registering or updating them must wake every window
+static bool haveResourcesChanged()
+{
+    const u64 generation = Resources::GetGeneration();
+    const bool changed = generation != s_Data->ResourceGeneration;
+    s_Data->ResourceGeneration = generation;
+    return changed;
+}
+
+// paced windows wait for the image presented before the last one right before acquiring the next image. by then it is
+// usually on screen already, so this rarely blocks and the last frame keeps the gpu busy. only a wait that actually
+// blocked returns at a vblank, so otherwise (or without present wait) the last known one is extrapolated instead
+static void waitForPreviousPresent(WindowData &wdata)
+{
+    wdata.Presented = false;
+    if (!wdata.IsPaced())
+        return;
+
+    TKIT_PROFILE_NSCOPE("Onyx::Application::PresentWait");
+    const TKit::Timespan period = wdata.GetPacingPeriod();
+    const Timeout timeout = (4.f * period).As<TKit::Timespan::Nanoseconds, u64>();
+
+    const TKit::Timespan start = GetTime();
+    const bool waited = wdata.Window->WaitForPreviousPresent(timeout);
+    const TKit::Timespan now = GetTime();
+
+    // waits shorter than this are just the cost of the call itself
+    const TKit::Timespan blockThreshold = 0.05f * period;
+    wdata.MarkPresented(waited && now - start > blockThreshold ? now : wdata.PredictVBlank(now));
+}
+
+static bool hasWindowChanged(WindowData &wdata)
+{
+    const Window *win = wdata.Window;
+
+    ViewMask vmask{};
+    bool changed = haveViewsChanged<D2>(win, vmask);
+    changed |= haveViewsChanged<D3>(win, vmask);
+
+    const u64 generation = Renderer::GetViewGeneration(vmask);
+    const u32 vcount = win->GetRenderViews<D2>().GetSize() + win->GetRenderViews<D3>().GetSize();
+    changed |=
+        generation != wdata.ViewGeneration || vcount != wdata.ViewCount || win->ClearColor.rgba != wdata.ClearColor;
+
+    wdata.ViewGeneration = generation;
+    wdata.ViewCount = vcount;
+    wdata.ClearColor = win->ClearColor.rgba;
+    return changed;
+}
+
 void Render(const RenderInfo &info)
 {
     TKIT_PROFILE_NSCOPE("Onyx::Render");
@@ -348,18 +554,40 @@ void Render(const RenderInfo &info)
     TKit::StackArray<AcquiredWindow> acqWindows{};
     acqWindows.Reserve(winCount);
 
+    const bool dataChanged = haveRenderTexturesChanged() | haveResourcesChanged();
     for (WindowData &wdata : s_Data->Windows)
     {
         Window *win = wdata.Window;
+        const bool events = !win->GetNewEvents().IsEmpty();
         for (const Event &event : win->GetNewEvents())
             if (win->GetPresentMode() == PresentMode_VSync &&
                 (event.Type == Event_SwapchainRecreated || event.Type == Event_WindowMoved))
                 wdata.DeltaTarget = win->GetMonitorDeltaTime();
 
         win->FlushEvents();
-        if (wdata.IsDue() && win->AcquireNextImage(info.AcquireImageTimeout))
+        if (wdata.Flags & OpenWindowFlag_SkipIdleFrames)
+        {
+            // the last presented image is still valid, so there is no need to acquire a new one
+            if (hasWindowChanged(wdata) || events || dataChanged)
+                wdata.ActiveFrames = WindowData::IdleSettleFrames;
+            else if (wdata.ActiveFrames == 0)
+            {
+                wdata.Idle = true;
+                continue;
+            }
+        }
+
+        if (wdata.Presented)
+            waitForPreviousPresent(wdata);
+
+        const TKit::Timespan now = GetTime();
+        if (wdata.IsDue(now) && win->AcquireNextImage(info.AcquireImageTimeout))
         {
-            wdata.MarkTick();
+            if (wdata.Idle)
+                wdata.MarkWake();
+            else
+                wdata.MarkTick();
+            wdata.FrameStart = now;
             AcquiredWindow &acwin = acqWindows.Append();
             acwin.Window = &wdata;
         }
@@ -393,6 +621,7 @@ void Render(const RenderInfo &info)
             const RenderSubmitInfo rinfo = Renderer::Render(gqueue, cmd, rtex);
             Execution::EndCommandBuffer(cmd);
             rinfos.Append(rinfo);
+            markViewsRendered(rtex);
         }
 
 #ifdef ONYX_ENABLE_IMGUI
@@ -434,6 +663,11 @@ void Render(const RenderInfo &info)
             maxFlight = rinfo.InFlightValue;
             Execution::EndCommandBuffer(cmd);
             rinfos.Append(rinfo);
+            if (wdata->Flags & OpenWindowFlag_SkipIdleFrames)
+            {
+                --wdata->ActiveFrames;
+                markViewsRendered(wdata->Window);
+            }
 
 #ifdef ONYX_ENABLE_IMGUI
             if (wdata->ImContext && multiViewports())
@@ -469,6 +703,7 @@ void Render(const RenderInfo &info)
         {
             WindowData *wdata = acwin.Window;
             wdata->Window->Present();
+            wdata->MarkSubmitted(GetTime());
 #ifdef ONYX_ENABLE_IMGUI
             if (wdata->ImContext)
             {
@@ -494,18 +729,21 @@ void Render(const RenderInfo &info)
             closeWindow(i);
     }
 
-    if (!s_Data->Windows.IsEmpty())
+    // idle windows are not waited on here. if all of them are idle, Running() will block on events instead
+    const TKit::Timespan now = GetTime();
+    bool anyActive = false;
+    TKit::Timespan sleep{};
+    for (const WindowData &wdata : s_Data->Windows)
+    {
+        if (wdata.Idle)
+            continue;
+        const TKit::Timespan s = wdata.ComputeSleep(now);
+        if (!anyActive || s < sleep)
+            sleep = s;
+        anyActive = true;
+    }
+    if (anyActive)
     {
-        const auto computeSleep = [](WindowData &wdata) {
-            return wdata.DeltaTarget - wdata.Clock.GetElapsed() - wdata.DeltaError;
-        };
-        TKit::Timespan sleep = computeSleep(s_Data->Windows[0]);
-        for (u32 i = 1; i < s_Data->Windows.GetSize(); ++i)
-        {
-            const TKit::Timespan s = computeSleep(s_Data->Windows[i]);
-            if (s < sleep)
-                sleep = s;
-        }
         if (sleep > TKit::Timespan{})
         {
             TKIT_PROFILE_NSCOPE("Onyx::Application::Sleep");
@@ -516,6 +754,122 @@ void Render(const RenderInfo &info)
     TKIT_PROFILE_MARK_FRAME();
 }
 
+// records and submits a single render texture, outside of the window driven render loop
+static Execution::Tracker renderTexture(RenderTexture *rtex)
+{
+    rtex->FindAvailableImages();
+
+    VKit::Queue *gqueue = Execution::GetQueue(VKit::Queue_Graphics);
+    CommandPool *gpool = Execution::FindAvailableCommandPool(VKit::Queue_Graphics);
+
+    Renderer::PrepareRender();
+    const VkCommandBuffer cmd = Execution::Allocate(gpool);
+
+    Execution::BeginCommandBuffer(cmd);
+    Resources::UpdateTextureIdOffsetBuffer(cmd);
+    Renderer::ApplyAcquireBarriers(cmd);
+    const RenderSubmitInfo rinfo = Renderer::Render(gqueue, cmd, rtex);
+    Execution::EndCommandBuffer(cmd);
+
+    rtex->MarkReadImageInUse({.Queue = gqueue, .InFlightValue = rinfo.InFlightValue});
+
+    TKit::StaticArray<RenderSubmitInfo, 1> rinfos{};
+    rinfos.Append(rinfo);
+    Renderer::SubmitRender(gqueue, gpool, rinfos);
+    return {.Queue = gqueue, .InFlightValue = rinfo.InFlightValue};
+}
+
+static void waitForRender(const Execution::Tracker &tracker)
+{
+    if (!tracker.InFlight())
+        return;
+
+    TKIT_PROFILE_NSCOPE("Onyx::RenderOffline::Throttle");
+    const VkSemaphore sm = tracker.Queue->GetTimelineSempahore();
+    VkSemaphoreWaitInfoKHR waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &sm;
+    waitInfo.pValues = &tracker.InFlightValue;
+
+    const auto table = GetDeviceTable();
+    const auto &device = GetDevice();
+    ONYX_CHECK_VKIT_RESULT(table->WaitSemaphoresKHR(device, &waitInfo, TKIT_U64_MAX));
+}
+
+void RenderOffline(const OfflineRenderSpecs &specs)
+{
+    TKIT_PROFILE_NSCOPE("Onyx::RenderOffline");
+    TKIT_ASSERT(specs.Target, "[ONYX] A render texture must be provided to render offline");
+    TKIT_ASSERT(specs.FramesInFlight > 0, "[ONYX] At least one frame in flight is required to render offline");
+
+    struct OfflineFrame
+    {
+        u32 Frame;
+        ReadbackTicket Ticket;
+        Task *Writer = nullptr;
+    };
+
+    RenderTexture *rtex = specs.Target;
+    TKit::ITaskManager *tm = GetTaskManager();
+    TKit::TierAllocator *tier = TKit::GetTier();
+    TKit::TierArray<OfflineFrame> frames{};
+    TKit::TierArray<Execution::Tracker> renders{};
+
+    const auto dispatch = [&](OfflineFrame &frame) {
+        const Readback readback = rtex->GetReadback(frame.Ticket);
+        frame.Writer = tier->Create<Task>(
+            [&specs, readback, index = frame.Frame] { specs.OnReadback(index, readback, specs.UserData); });
+        tm->SubmitTask(frame.Writer);
+    };
+    const auto retire = [&](OfflineFrame &frame) {
+        if (!frame.Writer)
+        {
+            rtex->WaitReadback(frame.Ticket);
+            Execution::UpdateCompletedQueueTimelines();
+            dispatch(frame);
+        }
+        tm->WaitUntilFinished(*frame.Writer);
+        tier->Destroy(frame.Writer);
+        rtex->ReleaseReadback(frame.Ticket);
+    };
+
+    for (u32 i = 0; i < specs.FrameCount; ++i)
+    {
+        // never run more than FramesInFlight frames ahead of the gpu, even if nothing is read back
+        if (renders.GetSize() == specs.FramesInFlight)
+        {
+            waitForRender(renders[0]);
+            renders.RemoveOrdered(renders.begin());
+        }
+
+        if (specs.OnFrame)
+            specs.OnFrame(i, specs.UserData);
+        Transfer(specs.Transfer);
+
+        if (specs.OnReadback)
+        {
+            if (frames.GetSize() == specs.FramesInFlight)
+            {
+                retire(frames[0]);
+                frames.RemoveOrdered(frames.begin());
+            }
+            frames.Append(OfflineFrame{.Frame = i, .Ticket = rtex->RequestReadback()});
+        }
+
+        renders.Append(renderTexture(rtex));
+
+        // hand whatever already finished to the workers without waiting
+        Execution::UpdateCompletedQueueTimelines();
+        for (OfflineFrame &frame : frames)
+            if (!frame.Writer && rtex->IsReadbackReady(frame.Ticket))
+                dispatch(frame);
+    }
+
+    for (OfflineFrame &frame : frames)
+        retire(frame);
+}
+
 void InitializeApi()
 {
     s_Data.Construct();
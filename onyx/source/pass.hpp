@@ -23,6 +23,8 @@ enum RenderPass : u8
 enum StandalonePass : u8
 {
     StandalonePass_RayMarch,
+    StandalonePass_LightCull,
+    StandalonePass_DepthReduce,
     StandalonePass_Blend,
     StandalonePass_PostProcess,
     StandalonePass_Compositor,
@@ -2,7 +2,9 @@
 #include "tkit/preprocessor/system.hpp"
 #if defined(ONYX_ENABLE_IMAGE_LOAD) && !defined(ONYX_ENABLE_GLTF_LOAD)
 #    define STB_IMAGE_IMPLEMENTATION
+#    define STB_IMAGE_WRITE_IMPLEMENTATION
 #    include <stb_image.h>
+#    include <stb_image_write.h>
 #elif defined(ONYX_ENABLE_GLTF_LOAD)
 #    define TINYGLTF_IMPLEMENTATION
 #    define STB_IMAGE_IMPLEMENTATION
@@ -12,7 +12,7 @@
 #    include "vkit/state/shader.hpp"
 #    include "spirv.hpp"
 #endif
-#include "onyx/vertex.hpp"
+#include "vertex.hpp"
 #include "platform.hpp"
 #include "tkit/preprocessor/utils.hpp"
 #include "tkit/container/stack_array.hpp"
@@ -27,6 +27,8 @@ struct ShaderData
     TKit::FixedArray<VKit::Shader, Geometry_Count> VertexShaders{};
     TKit::FixedArray<VKit::Shader, Geometry_Count> OpaqueFragmentShaders{};
     TKit::FixedArray<VKit::Shader, Geometry_Count> TransparentFragmentShaders{};
+    // only the shaded pass has them. used by the depth prepass, they only run the discards of the opaque shaders
+    TKit::FixedArray<VKit::Shader, Geometry_Count> DepthFragmentShaders{};
 
     void Destroy()
     {
@@ -36,6 +38,8 @@ struct ShaderData
             sh.Destroy();
         for (VKit::Shader &sh : TransparentFragmentShaders)
             sh.Destroy();
+        for (VKit::Shader &sh : DepthFragmentShaders)
+            sh.Destroy();
     }
 };
 
@@ -80,23 +84,26 @@ static void createPipelineLayouts()
             .AddPushConstantRange<ShadedPushConstantData<D2>>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
             .Build());
 
+    const VKit::DescriptorSetLayout &lightTiles = Descriptors::GetDescriptorLayout(StandalonePass_LightCull);
+
     s_PipelineData->Layouts[Dim3][RenderPass_Shaded] = ONYX_CHECK_VKIT_RESULT(
         VKit::PipelineLayout::Builder(device)
             .AddDescriptorSetLayout(shaded3)
+            .AddDescriptorSetLayout(lightTiles)
             .AddPushConstantRange<ShadedPushConstantData<D3>>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
             .Build());
 
-    s_PipelineData->Layouts[Dim2][RenderPass_Flat] =
-        ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
-                                   .AddDescriptorSetLayout(flat2)
-                                   .AddPushConstantRange<FlatPushConstantData>(VK_SHADER_STAGE_VERTEX_BIT)
-                                   .Build());
+    s_PipelineData->Layouts[Dim2][RenderPass_Flat] = ONYX_CHECK_VKIT_RESULT(
+        VKit::PipelineLayout::Builder(device)
+            .AddDescriptorSetLayout(flat2)
+            .AddPushConstantRange<FlatPushConstantData>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+            .Build());
 
-    s_PipelineData->Layouts[Dim3][RenderPass_Flat] =
-        ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
-                                   .AddDescriptorSetLayout(flat3)
-                                   .AddPushConstantRange<FlatPushConstantData>(VK_SHADER_STAGE_VERTEX_BIT)
-                                   .Build());
+    s_PipelineData->Layouts[Dim3][RenderPass_Flat] = ONYX_CHECK_VKIT_RESULT(
+        VKit::PipelineLayout::Builder(device)
+            .AddDescriptorSetLayout(flat3)
+            .AddPushConstantRange<FlatPushConstantData>(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
+            .Build());
 
     s_PipelineData->Layouts[Dim2][RenderPass_Shadow] =
         ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
@@ -116,6 +123,20 @@ static void createPipelineLayouts()
                                    .AddPushConstantRange<RayMarchPushConstantData>(VK_SHADER_STAGE_COMPUTE_BIT)
                                    .Build());
 
+    // shares its first set with the 3D shaded layout so that it can read the light buffers from the same sets
+    s_PipelineData->Standalone[StandalonePass_LightCull].Layout =
+        ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
+                                   .AddDescriptorSetLayout(shaded3)
+                                   .AddDescriptorSetLayout(lightTiles)
+                                   .AddPushConstantRange<LightCullPushConstantData>(VK_SHADER_STAGE_COMPUTE_BIT)
+                                   .Build());
+
+    s_PipelineData->Standalone[StandalonePass_DepthReduce].Layout =
+        ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
+                                   .AddDescriptorSetLayout(Descriptors::GetDescriptorLayout(StandalonePass_DepthReduce))
+                                   .AddPushConstantRange<DepthReducePushConstantData>(VK_SHADER_STAGE_COMPUTE_BIT)
+                                   .Build());
+
     s_PipelineData->Standalone[StandalonePass_Blend].Layout =
         ONYX_CHECK_VKIT_RESULT(VKit::PipelineLayout::Builder(device)
                                    .AddDescriptorSetLayout(Descriptors::GetDescriptorLayout(StandalonePass_Blend))
@@ -142,6 +163,10 @@ static void createPipelineLayouts()
         });
         ONYX_CHECK_VKIT_RESULT(
             s_PipelineData->Standalone[StandalonePass_RayMarch].Layout.SetName("onyx-ray-march-pipeline-layout"));
+        ONYX_CHECK_VKIT_RESULT(
+            s_PipelineData->Standalone[StandalonePass_LightCull].Layout.SetName("onyx-light-cull-pipeline-layout"));
+        ONYX_CHECK_VKIT_RESULT(s_PipelineData->Standalone[StandalonePass_DepthReduce].Layout.SetName(
+            "onyx-depth-reduce-pipeline-layout"));
         ONYX_CHECK_VKIT_RESULT(
             s_PipelineData->Standalone[StandalonePass_Blend].Layout.SetName("onyx-blend-pipeline-layout"));
         ONYX_CHECK_VKIT_RESULT(
@@ -224,6 +249,8 @@ static void createShaders()
                                    .DeclareEntryPoint("mainFSO", ShaderStage_Fragment);
                 if (rpass != RenderPass_Shadow)
                     module.DeclareEntryPoint("mainFST", ShaderStage_Fragment);
+                if (rpass == RenderPass_Shaded)
+                    module.DeclareEntryPoint("mainFSD", ShaderStage_Fragment);
                 module.Load();
             }
 
@@ -246,12 +273,15 @@ static void createShaders()
     Shaders::Compilation cmp = ONYX_CHECK_RESULT(compiler.Compile());
 
     u32 idx = 0;
-    const auto createShader = [&](const Geometry geo, ShaderData &data, const bool hasTransparent) {
+    const auto createShader = [&](const Geometry geo, ShaderData &data, const bool hasTransparent,
+                                  const bool hasDepth) {
         const TKit::TierString &name = names[idx++];
         data.VertexShaders[geo] = ONYX_CHECK_RESULT(cmp.CreateShader("mainVS", name.GetData()));
         data.OpaqueFragmentShaders[geo] = ONYX_CHECK_RESULT(cmp.CreateShader("mainFSO", name.GetData()));
         if (hasTransparent)
             data.TransparentFragmentShaders[geo] = ONYX_CHECK_RESULT(cmp.CreateShader("mainFST", name.GetData()));
+        if (hasDepth)
+            data.DepthFragmentShaders[geo] = ONYX_CHECK_RESULT(cmp.CreateShader("mainFSD", name.GetData()));
 
         if (IsDebugUtilsEnabled())
         {
@@ -264,6 +294,11 @@ static void createShaders()
                 const TKit::TierString tf = "onyx-transparent-fragment-shader-" + name;
                 ONYX_CHECK_VKIT_RESULT(data.TransparentFragmentShaders[geo].SetName(tf.CString()));
             }
+            if (hasDepth)
+            {
+                const TKit::TierString df = "onyx-depth-fragment-shader-" + name;
+                ONYX_CHECK_VKIT_RESULT(data.DepthFragmentShaders[geo].SetName(df.CString()));
+            }
         }
     };
 
@@ -273,14 +308,18 @@ static void createShaders()
         for (u32 j = 0; j < passes.GetSize(); ++j)
         {
             const RenderPass rpass = RenderPass(j);
-            createShader(geo, getShaders<D2>(rpass), rpass != RenderPass_Shadow);
-            createShader(geo, getShaders<D3>(rpass), rpass != RenderPass_Shadow);
+            createShader(geo, getShaders<D2>(rpass), rpass != RenderPass_Shadow, rpass == RenderPass_Shaded);
+            createShader(geo, getShaders<D3>(rpass), rpass != RenderPass_Shadow, rpass == RenderPass_Shaded);
         }
     }
 
     s_PipelineData->FullPassVertexShader = ONYX_CHECK_RESULT(cmp.CreateShader("mainVS", "full-vertex"));
     s_PipelineData->Standalone[StandalonePass_RayMarch].Shader =
         ONYX_CHECK_RESULT(cmp.CreateShader("main", "ray-march"));
+    s_PipelineData->Standalone[StandalonePass_LightCull].Shader =
+        ONYX_CHECK_RESULT(cmp.CreateShader("main", "light-cull"));
+    s_PipelineData->Standalone[StandalonePass_DepthReduce].Shader =
+        ONYX_CHECK_RESULT(cmp.CreateShader("main", "depth-reduce"));
 
     s_PipelineData->Standalone[StandalonePass_Blend].Shader = ONYX_CHECK_RESULT(cmp.CreateShader("mainFS", "blend"));
     s_PipelineData->Standalone[StandalonePass_PostProcess].Shader =
@@ -301,11 +340,16 @@ static void createShaders()
                 if (rpass != RenderPass_Shadow)
                     sdata.TransparentFragmentShaders[geo] =
                         shaderFromBinary(g_ShaderBinaryData.TransparentFragmentShaders[dim][rpass][geo]);
+                if (rpass == RenderPass_Shaded)
+                    sdata.DepthFragmentShaders[geo] =
+                        shaderFromBinary(g_ShaderBinaryData.DepthFragmentShaders[dim][geo]);
             }
 
     s_PipelineData->FullPassVertexShader = shaderFromBinary(g_ShaderBinaryData.FullVertex);
 
     s_PipelineData->Standalone[StandalonePass_RayMarch].Shader = shaderFromBinary(g_ShaderBinaryData.RayMarch);
+    s_PipelineData->Standalone[StandalonePass_LightCull].Shader = shaderFromBinary(g_ShaderBinaryData.LightCull);
+    s_PipelineData->Standalone[StandalonePass_DepthReduce].Shader = shaderFromBinary(g_ShaderBinaryData.DepthReduce);
     s_PipelineData->Standalone[StandalonePass_Blend].Shader = shaderFromBinary(g_ShaderBinaryData.Blend);
     s_PipelineData->Standalone[StandalonePass_PostProcess].Shader = shaderFromBinary(g_ShaderBinaryData.PostProcess);
     s_PipelineData->Standalone[StandalonePass_Compositor].Shader = shaderFromBinary(g_ShaderBinaryData.Compositor);
@@ -359,29 +403,87 @@ const VKit::PipelineLayout &GetPipelineLayout(const StandalonePass pass)
     return s_PipelineData->Standalone[pass].Layout;
 }
 
+// the specialization data must outlive the builder, so it is owned by the caller
+struct Specialization
+{
+    VkSpecializationInfo Info{};
+    TKit::FixedArray<VkSpecializationMapEntry, 2> Entries{};
+    TKit::FixedArray<u32, 2> Data{};
+
+    VkSpecializationInfo VertexInfo{};
+    VkSpecializationMapEntry VertexEntry{};
+    u32 VertexData = 0;
+};
+
+template <Dimension D> static bool usesQuantizedVertices(const Geometry geo)
+{
+    return D == D3 && geo == Geometry_Static && Renderer::HasQuantizedStaticMeshes();
+}
+
+// only static 3D vertex shaders read constant 2, which tells them how to decode their vertices
+template <Dimension D>
+static const VkSpecializationInfo *createVertexSpecialization(Specialization &spec, const Geometry geo)
+{
+    if (D != D3 || geo != Geometry_Static)
+        return nullptr;
+
+    spec.VertexData = u32(usesQuantizedVertices<D>(geo));
+    spec.VertexEntry.constantID = 2;
+    spec.VertexEntry.offset = 0;
+    spec.VertexEntry.size = sizeof(u32);
+    spec.VertexInfo.dataSize = sizeof(u32);
+    spec.VertexInfo.pData = &spec.VertexData;
+    spec.VertexInfo.mapEntryCount = 1;
+    spec.VertexInfo.pMapEntries = &spec.VertexEntry;
+    return &spec.VertexInfo;
+}
+
+static void addQuantizedStaticAttributes(VKit::GraphicsPipeline::Builder &builder, const bool texCoords,
+                                         const bool tangentFrame)
+{
+    builder.AddBindingDescription<QuantizedStaticVertex3>();
+    builder.AddAttributeDescription(0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(QuantizedStaticVertex3, Position));
+    if (texCoords)
+        builder.AddAttributeDescription(0, VK_FORMAT_R16G16_SFLOAT, offsetof(QuantizedStaticVertex3, TexCoord));
+    if (tangentFrame)
+    {
+        builder.AddAttributeDescription(0, VK_FORMAT_R16G16_SNORM, offsetof(QuantizedStaticVertex3, Normal));
+        builder.AddAttributeDescription(0, VK_FORMAT_R16G16_SNORM, offsetof(QuantizedStaticVertex3, Tangent));
+    }
+}
+
 template <Dimension D>
 static VKit::GraphicsPipeline::Builder createGeometryPipelineBuilder(const PipelinePass pass, const Geometry geo,
+                                                                     const VkSampleCountFlagBits samples,
                                                                      const VkPipelineRenderingCreateInfoKHR &renderInfo,
-                                                                     VkSpecializationInfo &spInfo,
-                                                                     VkSpecializationMapEntry &entry)
+                                                                     Specialization &spec, const u32 shadedFeatures,
+                                                                     const bool depthPrepass)
 {
     const RenderPass rpass = GetRenderPass(pass);
     const ShaderData &shaders = getShaders<D>(rpass);
 
-    const VkColorComponentFlags full =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    // the prepass keeps the shaded vertex shader so that its depth matches the main pass exactly, but swaps in a depth
+    // only fragment shader that just discards clipped and cut out fragments, with no color work
+    const VkColorComponentFlags full = depthPrepass ? 0
+                                                    : VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
 
-    const bool needsConstant = D == D2 && pass == PipelinePass_Shaded;
-    const u32 depth2 = u32(Renderer::IsDepthSupportedFor2D());
+    // constant 0 only exists in 2D shaded shaders, but entries for missing constants are ignored
+    const bool needsConstant = pass == PipelinePass_Shaded && !depthPrepass;
     if (needsConstant)
     {
-        entry.constantID = 0;
-        entry.offset = 0;
-        entry.size = sizeof(u32);
-        spInfo.dataSize = sizeof(u32);
-        spInfo.pData = &depth2;
-        spInfo.mapEntryCount = 1;
-        spInfo.pMapEntries = &entry;
+        spec.Data[0] = u32(D == D2 && Renderer::IsDepthSupportedFor2D());
+        spec.Data[1] = shadedFeatures & ShadedFlag_Specialized;
+        for (u32 i = 0; i < spec.Entries.GetSize(); ++i)
+        {
+            spec.Entries[i].constantID = i;
+            spec.Entries[i].offset = i * sizeof(u32);
+            spec.Entries[i].size = sizeof(u32);
+        }
+        spec.Info.dataSize = spec.Data.GetSize() * sizeof(u32);
+        spec.Info.pData = spec.Data.GetData();
+        spec.Info.mapEntryCount = spec.Entries.GetSize();
+        spec.Info.pMapEntries = spec.Entries.GetData();
     }
 
     VKit::GraphicsPipeline::Builder builder{GetDevice(), GetPipelineLayout<D>(rpass), renderInfo};
@@ -398,11 +500,15 @@ static VKit::GraphicsPipeline::Builder createGeometryPipelineBuilder(const Pipel
     builder.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
         .AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
         .SetViewportCount(1)
-        .AddShaderStage(shaders.VertexShaders[geo], VK_SHADER_STAGE_VERTEX_BIT)
-        .AddShaderStage(opaque ? shaders.OpaqueFragmentShaders[geo] : shaders.TransparentFragmentShaders[geo],
-                        VK_SHADER_STAGE_FRAGMENT_BIT, 0, needsConstant ? &spInfo : nullptr)
+        .SetSampleCount(samples)
+        .AddShaderStage(shaders.VertexShaders[geo], VK_SHADER_STAGE_VERTEX_BIT, 0,
+                        createVertexSpecialization<D>(spec, geo))
+        .AddShaderStage(depthPrepass ? shaders.DepthFragmentShaders[geo]
+                        : opaque     ? shaders.OpaqueFragmentShaders[geo]
+                                     : shaders.TransparentFragmentShaders[geo],
+                        VK_SHADER_STAGE_FRAGMENT_BIT, 0, needsConstant ? &spec.Info : nullptr)
         .BeginColorAttachment()
-        .EnableBlending(!opaque || geo == Geometry_Glyph)
+        .EnableBlending(!depthPrepass && (!opaque || geo == Geometry_Glyph))
         // .EnableBlending(!opaque)
         .SetColorBlendFactors(csrc, cdst)
         .SetAlphaBlendFactors(asrc, adst)
@@ -425,12 +531,16 @@ static VKit::GraphicsPipeline::Builder createGeometryPipelineBuilder(const Pipel
             .SetColorWriteMask(pass != PipelinePass_Outlined ? full : 0)
             .EndColorAttachment();
 
+    // the compare op depends on whether the view uses reversed depth, and opaque shaded pipelines either write depth
+    // as usual or test against the depth laid down by a prepass. both are per view choices
     if (pass == PipelinePass_Shaded || pass == PipelinePass_Flat)
     {
-        builder.EnableDepthTest();
+        builder.EnableDepthTest().AddDynamicState(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT);
         if (opaque)
             builder.EnableDepthWrite();
     }
+    if (pass == PipelinePass_Shaded && opaque && !depthPrepass)
+        builder.AddDynamicState(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT);
 
     if (pass == PipelinePass_Outlined)
     {
@@ -449,7 +559,9 @@ static VKit::GraphicsPipeline::Builder createGeometryPipelineBuilder(const Pipel
 }
 
 template <Dimension D>
-VKit::GraphicsPipeline CreateGeometryPipeline(const PipelinePass pass, const BlendPass bpass, const Geometry geo)
+static VKit::GraphicsPipeline createGeometryPipeline(const PipelinePass pass, const BlendPass bpass, const Geometry geo,
+                                                     const VkSampleCountFlagBits samples, const u32 shadedFeatures,
+                                                     const bool depthPrepass)
 {
     const VkFormat cf = GetAttachmentFormat(Attachment_Intermediate);
     const VkFormat tf = GetAttachmentFormat(Attachment_Transparent);
@@ -473,15 +585,19 @@ VKit::GraphicsPipeline CreateGeometryPipeline(const PipelinePass pass, const Ble
     rinfo.depthAttachmentFormat = GetAttachmentFormat(Attachment_DepthStencil);
     rinfo.stencilAttachmentFormat = rinfo.depthAttachmentFormat;
 
-    VkSpecializationInfo spInfo{};
-    VkSpecializationMapEntry entry{};
-
-    VKit::GraphicsPipeline::Builder builder = createGeometryPipelineBuilder<D>(pass, geo, rinfo, spInfo, entry);
+    Specialization spec{};
+    VKit::GraphicsPipeline::Builder builder =
+        createGeometryPipelineBuilder<D>(pass, geo, samples, rinfo, spec, shadedFeatures, depthPrepass);
     switch (geo)
     {
     case Geometry_Circle:
         return ONYX_CHECK_VKIT_RESULT(builder.Bake().Build());
     case Geometry_Static:
+        if (usesQuantizedVertices<D>(geo))
+        {
+            addQuantizedStaticAttributes(builder, true, pass == PipelinePass_Shaded);
+            return ONYX_CHECK_VKIT_RESULT(builder.Bake().Build());
+        }
         builder.AddBindingDescription<StaticVertex<D>>();
         if constexpr (D == D2)
         {
@@ -560,15 +676,30 @@ VKit::GraphicsPipeline CreateGeometryPipeline(const PipelinePass pass, const Ble
     }
 }
 
+template <Dimension D>
+VKit::GraphicsPipeline CreateGeometryPipeline(const PipelinePass pass, const BlendPass bpass, const Geometry geo,
+                                              const VkSampleCountFlagBits samples, const u32 shadedFeatures)
+{
+    return createGeometryPipeline<D>(pass, bpass, geo, samples, shadedFeatures, false);
+}
+
+template <Dimension D>
+VKit::GraphicsPipeline CreateDepthPrepassPipeline(const Geometry geo, const VkSampleCountFlagBits samples)
+{
+    return createGeometryPipeline<D>(PipelinePass_Shaded, BlendPass_Opaque, geo, samples, 0, true);
+}
+
 template <Dimension D>
 static VKit::GraphicsPipeline::Builder createShadowPipelineBuilder(const Geometry geo,
-                                                                   const VkPipelineRenderingCreateInfoKHR &renderInfo)
+                                                                   const VkPipelineRenderingCreateInfoKHR &renderInfo,
+                                                                   Specialization &spec)
 {
     const ShaderData &shaders = getShaders<D>(RenderPass_Shadow);
     VKit::GraphicsPipeline::Builder builder{GetDevice(), GetPipelineLayout<D>(RenderPass_Shadow), renderInfo};
     builder.AddDynamicState(VK_DYNAMIC_STATE_VIEWPORT)
         .AddDynamicState(VK_DYNAMIC_STATE_SCISSOR)
-        .AddShaderStage(shaders.VertexShaders[geo], VK_SHADER_STAGE_VERTEX_BIT)
+        .AddShaderStage(shaders.VertexShaders[geo], VK_SHADER_STAGE_VERTEX_BIT, 0,
+                        createVertexSpecialization<D>(spec, geo))
         .AddShaderStage(shaders.OpaqueFragmentShaders[geo], VK_SHADER_STAGE_FRAGMENT_BIT)
         .SetViewportCount(1);
 
@@ -584,22 +715,31 @@ static VKit::GraphicsPipeline::Builder createShadowPipelineBuilder(const Geometr
     return builder;
 }
 
-template <Dimension D> VKit::GraphicsPipeline CreateShadowPipeline(const Geometry geo, const VkFormat format)
+template <Dimension D>
+VKit::GraphicsPipeline CreateShadowPipeline(const Geometry geo, const VkFormat format, const u32 viewMask)
 {
     VkPipelineRenderingCreateInfoKHR renderInfo{};
     renderInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    renderInfo.viewMask = viewMask;
     renderInfo.colorAttachmentCount = u32(D == D2);
     if constexpr (D == D2)
         renderInfo.pColorAttachmentFormats = &format;
     else
         renderInfo.depthAttachmentFormat = format;
 
-    VKit::GraphicsPipeline::Builder builder = createShadowPipelineBuilder<D>(geo, renderInfo);
+    Specialization spec{};
+    VKit::GraphicsPipeline::Builder builder = createShadowPipelineBuilder<D>(geo, renderInfo, spec);
     switch (geo)
     {
     case Geometry_Circle:
         return ONYX_CHECK_VKIT_RESULT(builder.Bake().Build());
     case Geometry_Static:
+        if (usesQuantizedVertices<D>(geo))
+        {
+            // shadow shaders only read the position
+            addQuantizedStaticAttributes(builder, false, false);
+            return ONYX_CHECK_VKIT_RESULT(builder.Bake().Build());
+        }
         builder.AddBindingDescription<StaticVertex<D>>();
         if constexpr (D == D2)
             builder.AddAttributeDescription(0, VK_FORMAT_R32G32_SFLOAT, offsetof(StaticVertex<D2>, Position));
@@ -654,6 +794,24 @@ VKit::ComputePipeline CreateRayMarchPipeline()
     return ONYX_CHECK_VKIT_RESULT(VKit::ComputePipeline::Create(GetDevice(), specs));
 }
 
+VKit::ComputePipeline CreateLightCullPipeline()
+{
+    VKit::ComputePipelineSpecs specs{};
+    StandalonePipelineData &data = s_PipelineData->Standalone[StandalonePass_LightCull];
+    specs.ComputeShader = data.Shader;
+    specs.Layout = data.Layout;
+    return ONYX_CHECK_VKIT_RESULT(VKit::ComputePipeline::Create(GetDevice(), specs));
+}
+
+VKit::ComputePipeline CreateDepthReducePipeline()
+{
+    VKit::ComputePipelineSpecs specs{};
+    StandalonePipelineData &data = s_PipelineData->Standalone[StandalonePass_DepthReduce];
+    specs.ComputeShader = data.Shader;
+    specs.Layout = data.Layout;
+    return ONYX_CHECK_VKIT_RESULT(VKit::ComputePipeline::Create(GetDevice(), specs));
+}
+
 VKit::GraphicsPipeline CreateBlendPipeline()
 {
     VkPipelineRenderingCreateInfoKHR rinfo{};
@@ -732,9 +890,13 @@ VKit::GraphicsPipeline CreateCompositorPipeline()
 template const VKit::PipelineLayout &GetPipelineLayout<D2>(RenderPass pass);
 template const VKit::PipelineLayout &GetPipelineLayout<D3>(RenderPass pass);
 
-template VKit::GraphicsPipeline CreateGeometryPipeline<D2>(PipelinePass pass, BlendPass bpass, Geometry geo);
-template VKit::GraphicsPipeline CreateGeometryPipeline<D3>(PipelinePass pass, BlendPass bpass, Geometry geo);
-template VKit::GraphicsPipeline CreateShadowPipeline<D2>(Geometry geo, VkFormat format);
-template VKit::GraphicsPipeline CreateShadowPipeline<D3>(Geometry geo, VkFormat format);
+template VKit::GraphicsPipeline CreateGeometryPipeline<D2>(PipelinePass pass, BlendPass bpass, Geometry geo,
+                                                           VkSampleCountFlagBits samples, u32 shadedFeatures);
+template VKit::GraphicsPipeline CreateGeometryPipeline<D3>(PipelinePass pass, BlendPass bpass, Geometry geo,
+                                                           VkSampleCountFlagBits samples, u32 shadedFeatures);
+template VKit::GraphicsPipeline CreateDepthPrepassPipeline<D2>(Geometry geo, VkSampleCountFlagBits samples);
+template VKit::GraphicsPipeline CreateDepthPrepassPipeline<D3>(Geometry geo, VkSampleCountFlagBits samples);
+template VKit::GraphicsPipeline CreateShadowPipeline<D2>(Geometry geo, VkFormat format, u32 viewMask);
+template VKit::GraphicsPipeline CreateShadowPipeline<D3>(Geometry geo, VkFormat format, u32 viewMask);
 
 } // namespace Onyx::Pipelines
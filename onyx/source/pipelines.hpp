@@ -17,10 +17,21 @@ const VKit::PipelineLayout &GetPipelineLayout(StandalonePass pass);
 // TODO(Isma): Make this public?
 void ReloadShaders();
 
-template <Dimension D> VKit::GraphicsPipeline CreateGeometryPipeline(PipelinePass pass, BlendPass bpass, Geometry geo);
-template <Dimension D> VKit::GraphicsPipeline CreateShadowPipeline(const Geometry geo, const VkFormat format);
+// geometry pipelines must match the sample count of the attachments they render to, which is a per view setting.
+// shaded pipelines are also specialized for the shaded features (ShadedFlag_Specialized) the views enable
+template <Dimension D>
+VKit::GraphicsPipeline CreateGeometryPipeline(PipelinePass pass, BlendPass bpass, Geometry geo,
+                                              VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+                                              u32 shadedFeatures = 0);
+// depth only variant of the opaque shaded pipelines, used by views with a depth prepass
+template <Dimension D>
+VKit::GraphicsPipeline CreateDepthPrepassPipeline(Geometry geo, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+template <Dimension D>
+VKit::GraphicsPipeline CreateShadowPipeline(const Geometry geo, const VkFormat format, const u32 viewMask = 0);
 
 VKit::ComputePipeline CreateRayMarchPipeline();
+VKit::ComputePipeline CreateLightCullPipeline();
+VKit::ComputePipeline CreateDepthReducePipeline();
 VKit::GraphicsPipeline CreateBlendPipeline();
 VKit::GraphicsPipeline CreatePostProcessPipeline();
 VKit::GraphicsPipeline CreateCompositorPipeline();
@@ -89,6 +89,11 @@ void PollEvents()
     glfwPollEvents();
 }
 
+void WaitEvents(const TKit::Timespan timeout)
+{
+    glfwWaitEventsTimeout(timeout.AsSeconds());
+}
+
 Onyx_MonitorHandle *GetMonitor(Onyx_WindowHandle *win)
 {
     return glfwGetWindowMonitor(win);
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "onyx/platform.hpp"
+#include "tkit/profiling/clock.hpp"
 
 namespace Onyx::Platform
 {
 void Initialize(const Specs &specs);
 void Terminate();
 void PollEvents();
+// blocks until an event arrives or the timeout expires
+void WaitEvents(TKit::Timespan timeout);
 
 constexpr VkSurfaceFormatKHR GetSurfaceFormat()
 {
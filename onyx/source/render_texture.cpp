@@ -4,6 +4,7 @@
 #include "execution.hpp"
 #include "resources.hpp"
 #include "attachment.hpp"
+#include "buffer.hpp"
 #include "platform.hpp"
 #include "tkit/profiling/macros.hpp"
 
@@ -16,6 +17,37 @@ struct FrontEndImage
     Resource Texture;
 };
 
+enum ReadbackState : u8
+{
+    Readback_Free,
+    Readback_Requested,
+    Readback_Recorded,
+    // released while its copy was still in flight. it is only reused once the copy completes
+    Readback_Released,
+};
+
+struct ReadbackBuffer
+{
+    VKit::DeviceBuffer Buffer{};
+    Execution::Tracker Tracker{};
+    ReadbackTicket Ticket = NullReadbackTicket;
+    u32v2 Dimensions{0};
+    ReadbackState State = Readback_Free;
+};
+
+static ReadbackBuffer *findReadback(const TKit::TierArray<ReadbackBuffer *> &readbacks, const ReadbackTicket ticket)
+{
+    for (ReadbackBuffer *rb : readbacks)
+        if (rb->State != Readback_Free && rb->State != Readback_Released && rb->Ticket == ticket)
+            return rb;
+    return nullptr;
+}
+
+static bool isReadbackAvailable(const ReadbackBuffer *rb)
+{
+    return rb->State == Readback_Free || (rb->State == Readback_Released && !rb->Tracker.InUse());
+}
+
 static VKit::DeviceImage createImage(const u32v2 &dimensions)
 {
     const auto &device = GetDevice();
@@ -64,6 +96,14 @@ RenderTexture::~RenderTexture()
             Resources::DestroyTexture(img->Texture);
         img->Image.Destroy();
     }
+
+    TKit::TierAllocator *tier = TKit::GetTier();
+    for (ReadbackBuffer *rb : m_Readbacks)
+    {
+        if (rb->Buffer)
+            rb->Buffer.Destroy();
+        tier->Destroy(rb);
+    }
 }
 
 void RenderTexture::Resize(const u32v2 &dims)
@@ -190,7 +230,7 @@ void RenderTexture::FindAvailableImages()
         nameImage(img->Image, m_Writable);
 }
 
-void RenderTexture::BeginRendering(const VkCommandBuffer cmd)
+void RenderTexture::BeginRendering(const VkCommandBuffer cmd, VKit::DeviceImage *source)
 {
     TKIT_PROFILE_NSCOPE("Onyx::RenderTexture::BeginRendering");
     TKIT_ASSERT(m_Writable != m_Readable,
@@ -208,21 +248,52 @@ void RenderTexture::BeginRendering(const VkCommandBuffer cmd)
                                      .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                  });
 
-    write->Image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                  {.DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
-
-                                   .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
-                                   .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+    const VkExtent2D extent = {m_Dimensions[0], m_Dimensions[1]};
+    const auto table = GetDeviceTable();
 
     VkRenderingAttachmentInfoKHR target{};
     target.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
     target.imageView = write->Image.GetView(1);
     target.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    target.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     target.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    target.clearValue.color = {{ClearColor.rgba[0], ClearColor.rgba[1], ClearColor.rgba[2], ClearColor.rgba[3]}};
 
-    const VkExtent2D extent = {m_Dimensions[0], m_Dimensions[1]};
+    if (source)
+    {
+        source->TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                 {.DstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                                  .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                  .DstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR});
+        write->Image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                      {.DstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                                       .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                       .DstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR});
+
+        VkImageCopy region{};
+        region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.extent = {extent.width, extent.height, 1};
+        table->CmdCopyImage(cmd, *source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, write->Image,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        write->Image.TransitionLayout(
+            cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            {.SrcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+             .DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+             .SrcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+             .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+        target.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    }
+    else
+    {
+        write->Image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                      {.DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+
+                                       .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                       .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+        target.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        target.clearValue.color = {{ClearColor.rgba[0], ClearColor.rgba[1], ClearColor.rgba[2], ClearColor.rgba[3]}};
+    }
+
     VkRenderingInfoKHR renderInfo{};
     renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
     renderInfo.renderArea = {{0, 0}, extent};
@@ -230,7 +301,6 @@ void RenderTexture::BeginRendering(const VkCommandBuffer cmd)
     renderInfo.colorAttachmentCount = 1;
     renderInfo.pColorAttachments = &target;
 
-    const auto table = GetDeviceTable();
     table->CmdBeginRenderingKHR(cmd, &renderInfo);
 }
 void RenderTexture::EndRendering(const VkCommandBuffer cmd)
@@ -240,6 +310,167 @@ void RenderTexture::EndRendering(const VkCommandBuffer cmd)
     // no sync. it is synced in begin, when this becomes a readable texture
     const auto table = GetDeviceTable();
     table->CmdEndRenderingKHR(cmd);
+    recordReadbacks(cmd);
+}
+
+void RenderTexture::recordReadbacks(const VkCommandBuffer cmd)
+{
+    FrontEndImage *write = m_Images[m_Writable];
+    bool any = false;
+    for (ReadbackBuffer *rb : m_Readbacks)
+        if (rb->State == Readback_Requested && !rb->Tracker.InUse())
+        {
+            any = true;
+            break;
+        }
+    if (!any)
+        return;
+
+    TKIT_PROFILE_NSCOPE("Onyx::RenderTexture::RecordReadbacks");
+    write->Image.TransitionLayout(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                  {.SrcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+                                   .DstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                                   .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                                   .DstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR});
+
+    const auto table = GetDeviceTable();
+    const VkDeviceSize size = VkDeviceSize(m_Dimensions[0]) * m_Dimensions[1] * 4;
+
+    TKit::StackArray<VkBufferMemoryBarrier2KHR> barriers{};
+    barriers.Reserve(m_Readbacks.GetSize());
+    for (ReadbackBuffer *rb : m_Readbacks)
+    {
+        // a buffer still written by an earlier copy is left requested until that copy completes
+        if (rb->State != Readback_Requested || rb->Tracker.InUse())
+            continue;
+
+        if (!rb->Buffer || rb->Buffer.GetInfo().Size < size)
+        {
+            if (rb->Buffer)
+                rb->Buffer.Destroy();
+            rb->Buffer = CreateBuffer(DeviceBufferFlag_HostMapped | DeviceBufferFlag_HostRandomAccess |
+                                          DeviceBufferFlag_Destination,
+                                      size);
+        }
+
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.imageExtent = {m_Dimensions[0], m_Dimensions[1], 1};
+        table->CmdCopyImageToBuffer(cmd, write->Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, rb->Buffer, 1, &region);
+
+        VkBufferMemoryBarrier2KHR &barrier = barriers.Append();
+        barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT_KHR;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT_KHR;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = rb->Buffer;
+        barrier.offset = 0;
+        barrier.size = size;
+
+        // the write image tracker is assigned by the renderer before rendering begins
+        rb->Tracker = write->Tracker;
+        rb->Dimensions = m_Dimensions;
+        rb->State = Readback_Recorded;
+    }
+
+    // back to the layout begin rendering expects the written image to be in
+    const VkImageMemoryBarrier2KHR imgBarrier = write->Image.CreateTransitionLayoutBarrier2(
+        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        {.SrcAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+         .DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+         .SrcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+         .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+
+    VkDependencyInfoKHR dep{};
+    dep.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dep.bufferMemoryBarrierCount = barriers.GetSize();
+    dep.pBufferMemoryBarriers = barriers.GetData();
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &imgBarrier;
+
+    table->CmdPipelineBarrier2KHR(cmd, &dep);
+    write->Image.SetLayout(imgBarrier.newLayout);
+}
+
+ReadbackTicket RenderTexture::RequestReadback()
+{
+    ReadbackBuffer *rb = nullptr;
+    for (ReadbackBuffer *r : m_Readbacks)
+        if (isReadbackAvailable(r))
+        {
+            rb = r;
+            break;
+        }
+
+    if (!rb)
+    {
+        TKIT_LOG_DEBUG("[ONYX][RENDER-TEXTURE] Failed to find an available readback buffer. Increasing readback pool "
+                       "to {} for this particular render texture",
+                       m_Readbacks.GetSize() + 1);
+        TKit::TierAllocator *tier = TKit::GetTier();
+        rb = m_Readbacks.Append(tier->Create<ReadbackBuffer>());
+    }
+
+    rb->Ticket = ++m_ReadbackCount;
+    rb->State = Readback_Requested;
+    return rb->Ticket;
+}
+
+bool RenderTexture::IsReadbackReady(const ReadbackTicket ticket) const
+{
+    const ReadbackBuffer *rb = findReadback(m_Readbacks, ticket);
+    TKIT_ASSERT(rb, "[ONYX][RENDER-TEXTURE] Readback ticket {} not found. It may have already been released", ticket);
+    return rb->State == Readback_Recorded && !rb->Tracker.InUse();
+}
+
+void RenderTexture::WaitReadback(const ReadbackTicket ticket) const
+{
+    const ReadbackBuffer *rb = findReadback(m_Readbacks, ticket);
+    TKIT_ASSERT(rb, "[ONYX][RENDER-TEXTURE] Readback ticket {} not found. It may have already been released", ticket);
+    TKIT_ASSERT(rb->State == Readback_Recorded,
+                "[ONYX][RENDER-TEXTURE] Cannot wait for readback ticket {} because it has not been recorded yet",
+                ticket);
+    if (!rb->Tracker.InFlight())
+        return;
+
+    TKIT_PROFILE_NSCOPE("Onyx::RenderTexture::WaitReadback");
+    const VkSemaphore sm = rb->Tracker.Queue->GetTimelineSempahore();
+    VkSemaphoreWaitInfoKHR waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &sm;
+    waitInfo.pValues = &rb->Tracker.InFlightValue;
+
+    const auto table = GetDeviceTable();
+    const auto &device = GetDevice();
+    ONYX_CHECK_VKIT_RESULT(table->WaitSemaphoresKHR(device, &waitInfo, TKIT_U64_MAX));
+}
+
+Readback RenderTexture::GetReadback(const ReadbackTicket ticket)
+{
+    if (!IsReadbackReady(ticket))
+        return Readback{};
+
+    ReadbackBuffer *rb = findReadback(m_Readbacks, ticket);
+    const VkDeviceSize size = VkDeviceSize(rb->Dimensions[0]) * rb->Dimensions[1] * 4;
+    ONYX_CHECK_VKIT_RESULT(rb->Buffer.Invalidate(size));
+
+    Readback readback;
+    readback.Pixels = scast<const std::byte *>(rb->Buffer.GetData());
+    readback.Dimensions = rb->Dimensions;
+    return readback;
+}
+
+void RenderTexture::ReleaseReadback(const ReadbackTicket ticket)
+{
+    ReadbackBuffer *rb = findReadback(m_Readbacks, ticket);
+    TKIT_ASSERT(rb, "[ONYX][RENDER-TEXTURE] Readback ticket {} not found. It may have already been released", ticket);
+    // the copy may still be writing the buffer, so it cannot be handed out again until it completes
+    rb->State = rb->State == Readback_Recorded && rb->Tracker.InUse() ? Readback_Released : Readback_Free;
 }
 
 void RenderTexture::MarkWriteImageInUse(const Execution::Tracker &tracker)
@@ -38,7 +38,7 @@ struct ContextInstanceRange
 {
     VkDeviceSize Offset = 0;
     VkDeviceSize Size = 0;
-    ViewMask ViewMask = 0;
+    ViewMask ViewMask{};
     u64 Generation = 0;
     u32 ContextIndex = TKIT_U32_MAX;
 };
@@ -87,6 +87,8 @@ template <typename T> struct Pool
 {
     VKit::DeviceBuffer Buffer{};
     TKit::TierArray<T> Ranges{};
+    // index of the range the next incremental coalesce resumes from
+    u32 CoalesceCursor = 0;
 };
 
 using TransferPool = Pool<TransferRange>;
@@ -109,7 +111,7 @@ struct GraphicsInstanceRange
 
     VkDeviceSize Offset = 0;
     VkDeviceSize Size = 0;
-    ViewMask ViewMask = 0;
+    ViewMask ViewMask{};
 
     Resource MeshHandle = NullHandle;
 
@@ -180,7 +182,15 @@ struct GeometryData
     TKit::FixedArray<InstanceArena, Geometry_Count> Arenas{};
     Arena VertexArena{};
     Arena IndexArena{};
-    ten<VKit::GraphicsPipeline, BlendPass_Count, PipelinePass_Count, Geometry_Count> Pipelines{};
+    // pipeline variants for sample counts other than 1 are only created once a view requests them. the same goes for
+    // shaded pipelines, which have one variant per combination of specialized shaded features. their slot in Pipelines
+    // is left empty
+    ten<VKit::GraphicsPipeline, SampleCount_Count, BlendPass_Count, PipelinePass_Count, Geometry_Count> Pipelines{};
+    ten<VKit::GraphicsPipeline, SampleCount_Count, ShadedVariant_Count, BlendPass_Count, Geometry_Count>
+        ShadedPipelines{};
+    ten<VKit::GraphicsPipeline, SampleCount_Count, Geometry_Count> PrepassPipelines{};
+    TKit::FixedArray<bool, SampleCount_Count> HasPipelines{};
+    ten<bool, SampleCount_Count, ShadedVariant_Count> HasShadedPipelines{};
 };
 
 template <typename LightParams> struct ContextLights
@@ -245,7 +255,7 @@ template <> struct ShadowData<D2>
     VkDescriptorSet RayMarchSet = VK_NULL_HANDLE;
     VkFormat OcclusionFormat = VK_FORMAT_UNDEFINED;
     VkFormat ShadowFormat = VK_FORMAT_UNDEFINED;
-    ViewMask DirtyShadowViews = 0;
+    ViewMask DirtyShadowViews{};
     bool UsesFallback = false;
 };
 
@@ -257,14 +267,41 @@ template <> struct ShadowData<D3>
     TKit::FixedArray<u32, LightTypeCount<D3>> ShadowResolutions{};
 
     ten<VKit::GraphicsPipeline, Geometry_Count> Pipelines{};
+    ten<VKit::GraphicsPipeline, Geometry_Count> PointPipelines{}; // multiview pipelines rendering every cube face
     VkFormat ShadowFormat = VK_FORMAT_UNDEFINED;
-    ViewMask DirtyShadowViews = 0;
+    ViewMask DirtyShadowViews{};
+};
+
+// point light shadows are rendered to all six faces of their cube map in a single multiview pass
+static constexpr u32 s_CubeFaceViewMask = (1U << 6) - 1;
+
+// deduplicated per context tables the instances of a context index into. the attribute table indexes the clip table in
+// turn, so both are always uploaded together
+enum ContextTable : u8
+{
+    ContextTable_Clips,
+    ContextTable_Attributes,
+    ContextTable_Count
+};
+
+// a context table lives in the graphics range of its arena with this generation, starting at the offset. a zero
+// generation means the context has no such table uploaded
+struct ContextTableRange
+{
+    GraphicsRange *Range = nullptr;
+    u64 Generation = 0;
+    u32 Offset = 0;
+    u32 Count = 0;
 };
 
 template <Dimension D> struct ContextInfo
 {
     RenderContext<D> *Context = nullptr;
+    TKit::FixedArray<ContextTableRange, ContextTable_Count> Tables{};
     u64 Generation = 0;
+    // attribute generation of the context when its tables were last uploaded
+    u64 AttributeGeneration = 0;
+    ViewMask Views{};
 
     bool IsDirty() const
     {
@@ -281,13 +318,29 @@ template <Dimension D> struct RendererData
     GeometryData Geometry{};
     LightData<D> Lights{};
     ShadowData<D> Shadows{};
+    TKit::FixedArray<Arena, ContextTable_Count> TableArenas{};
+    // index of the pool the next incremental coalesce resumes from
+    u32 CoalescePool = 0;
+    // set when this dimension finished the last sweep, so that the other one resumes first
+    bool CoalesceYield = false;
+
+    bool IsTableRangeReferenced(const ContextTable table, const GraphicsRange &grange) const
+    {
+        for (const ContextInfo<D> &cinfo : Contexts)
+        {
+            const u64 generation = cinfo.Tables[table].Generation;
+            if (generation != 0 && generation == grange.Generation)
+                return true;
+        }
+        return false;
+    }
 
     bool IsContextRangeClean(const ContextInstanceRange &crange) const
     {
         return crange.ContextIndex != TKIT_U32_MAX &&
                !Contexts[crange.ContextIndex].Context->IsDirty(crange.Generation);
     }
-    bool IsContextRangeClean(const ViewMask viewBit, const ContextInstanceRange &crange) const
+    bool IsContextRangeClean(const ViewMask &viewBit, const ContextInstanceRange &crange) const
     {
         return (crange.ViewMask & viewBit) && crange.ContextIndex != TKIT_U32_MAX &&
                !Contexts[crange.ContextIndex].Context->IsDirty(crange.Generation);
@@ -336,12 +389,47 @@ static TKit::Storage<RendererData<D3>> s_RendererData3{};
 static VKit::GraphicsPipeline s_BlendPipeline{};
 static VKit::GraphicsPipeline s_PostProcessPipeline{};
 static VKit::GraphicsPipeline s_CompositorPipeline{};
+static VKit::ComputePipeline s_LightCullPipeline{};
+static VKit::ComputePipeline s_DepthReducePipeline{};
 
 static VKit::Sampler s_LinearSampler{};
 static VKit::Sampler s_CompareSampler{};
 static VKit::Sampler s_NearSampler{};
+static VKit::Sampler s_UpscaleSampler{};
 
 static u64 s_SyncPointCount = 0;
+static bool s_QuantizedStaticMeshes = false;
+// instance data and its tables are written straight into host visible graphics buffers, with no staging copies
+static bool s_DirectInstanceWrites = false;
+
+// generation of the last context update that reached each view, so that callers can tell if a view's output is stale
+static TKit::FixedArray<u64, ONYX_MAX_VIEWS> s_ViewGenerations{};
+static u64 s_ViewGeneration = 0;
+
+static void markViewsChanged(const ViewMask &vmask)
+{
+    if (!vmask)
+        return;
+    ++s_ViewGeneration;
+    vmask.ForEach([](const u32 index) { s_ViewGenerations[index] = s_ViewGeneration; });
+}
+
+u64 GetViewGeneration(const ViewMask &vmask)
+{
+    u64 generation = 0;
+    vmask.ForEach([&generation](const u32 index) { generation = Math::Max(generation, s_ViewGenerations[index]); });
+    return generation;
+}
+
+// most significant view first, as integer masks are usually written
+[[maybe_unused]] static TKit::StackString formatViewMask(const ViewMask &vmask)
+{
+    char bits[ONYX_MAX_VIEWS + 1];
+    for (u32 i = 0; i < ONYX_MAX_VIEWS; ++i)
+        bits[i] = vmask.Contains(ONYX_MAX_VIEWS - 1 - i) ? '1' : '0';
+    bits[ONYX_MAX_VIEWS] = '\0';
+    return TKit::StackString::Format("{}", bits);
+}
 
 template <Dimension D> static RendererData<D> &getRendererData()
 {
@@ -380,6 +468,21 @@ template <Dimension D> static void updateInstanceDescriptorSets(const Geometry g
     }
 }
 
+template <Dimension D> static u32 getTableElementSize(const ContextTable table)
+{
+    return table == ContextTable_Clips ? u32(sizeof(WorldRect<D>)) : u32(sizeof(InstanceAttributes));
+}
+
+static u32 tableToBinding(const ContextTable table)
+{
+    return table == ContextTable_Clips ? ONYX_CLIP_RECTS_BINDING_POINT : ONYX_INSTANCE_ATTRIBUTES_BINDING_POINT;
+}
+
+static const char *tableToString(const ContextTable table)
+{
+    return table == ContextTable_Clips ? "clip" : "attribute";
+}
+
 static u32 lightToBinding(const LightType light)
 {
     switch (light)
@@ -403,6 +506,14 @@ template <Dimension D> static void updateLightDescriptorSets(const LightType lig
     Descriptors::BindBuffer<D>(lightToBinding(light), rdata.Descriptors[RenderPass_Shaded], info, RenderPass_Shaded);
 }
 
+template <Dimension D> static void updateTableDescriptorSets(const ContextTable table)
+{
+    RendererData<D> &rdata = getRendererData<D>();
+    const VkDescriptorBufferInfo info = rdata.TableArenas[table].Graphics.Buffer.CreateDescriptorInfo();
+    for (u32 i = 0; i < RenderPass_Count; ++i)
+        Descriptors::BindBuffer<D>(tableToBinding(table), rdata.Descriptors[i], info, RenderPass(i));
+}
+
 template <Dimension D>
 static VKit::DeviceBuffer createTransferInstanceBuffer(const Geometry geo,
                                                        const u32 instances = ONYX_BUFFER_INITIAL_CAPACITY)
@@ -433,6 +544,20 @@ static VKit::DeviceBuffer createTransferLightBuffer(const LightType light,
     return buffer;
 }
 
+template <Dimension D>
+static VKit::DeviceBuffer createTransferTableBuffer(const ContextTable table,
+                                                    const u32 elements = ONYX_BUFFER_INITIAL_CAPACITY)
+{
+    VKit::DeviceBuffer buffer = Onyx::CreateBuffer(Buffer_Staging, elements * getTableElementSize<D>(table));
+    if (IsDebugUtilsEnabled())
+    {
+        const TKit::StackString name =
+            TKit::StackString::Format("onyx-renderer-transfer-{}-buffer-{}D", tableToString(table), u8(D));
+        ONYX_CHECK_VKIT_RESULT(buffer.SetName(name.CString()));
+    }
+    return buffer;
+}
+
 template <Dimension D>
 static VKit::DeviceBuffer createTransferVertexBuffer(const u32 instances = ONYX_BUFFER_INITIAL_CAPACITY)
 {
@@ -467,7 +592,9 @@ template <Dimension D>
 static VKit::DeviceBuffer createGraphicsInstanceBuffer(const Geometry geo,
                                                        const u32 instances = ONYX_BUFFER_INITIAL_CAPACITY)
 {
-    const VKit::DeviceBufferFlags flags = VKit::DeviceBufferFlags(Buffer_DeviceStorage) | DeviceBufferFlag_Source;
+    const VKit::DeviceBufferFlags flags =
+        VKit::DeviceBufferFlags(s_DirectInstanceWrites ? Buffer_DeviceHostStorage : Buffer_DeviceStorage) |
+        DeviceBufferFlag_Source;
     VKit::DeviceBuffer buffer = Onyx::CreateBuffer(flags, instances * GetInstanceSize<D>(geo));
     if (IsDebugUtilsEnabled())
     {
@@ -492,6 +619,23 @@ static VKit::DeviceBuffer createGraphicsLightBuffer(const LightType light,
     return buffer;
 }
 
+template <Dimension D>
+static VKit::DeviceBuffer createGraphicsTableBuffer(const ContextTable table,
+                                                    const u32 elements = ONYX_BUFFER_INITIAL_CAPACITY)
+{
+    const VKit::DeviceBufferFlags flags =
+        VKit::DeviceBufferFlags(s_DirectInstanceWrites ? Buffer_DeviceHostStorage : Buffer_DeviceStorage) |
+        DeviceBufferFlag_Source;
+    VKit::DeviceBuffer buffer = Onyx::CreateBuffer(flags, elements * getTableElementSize<D>(table));
+    if (IsDebugUtilsEnabled())
+    {
+        const TKit::StackString name =
+            TKit::StackString::Format("onyx-renderer-graphics-{}-buffer-{}D", tableToString(table), u8(D));
+        ONYX_CHECK_VKIT_RESULT(buffer.SetName(name.CString()));
+    }
+    return buffer;
+}
+
 template <Dimension D>
 static VKit::DeviceBuffer createGraphicsVertexBuffer(const u32 instances = ONYX_BUFFER_INITIAL_CAPACITY)
 {
@@ -521,24 +665,112 @@ static VKit::DeviceBuffer createGraphicsIndexBuffer(const u32 instances = ONYX_B
     return buffer;
 }
 
-template <Dimension D> static void createPipelines()
+template <Dimension D> static void createGeometryPipelines(const SampleCount samples)
 {
-    RendererData<D> &rdata = getRendererData<D>();
-    ShadowData<D> &sdata = rdata.Shadows;
+    GeometryData &gdata = getRendererData<D>().Geometry;
+    const VkSampleCountFlagBits vksamples = AsVulkanSampleCount(samples);
+    for (u32 bpass = 0; bpass < BlendPass_Count; ++bpass)
+        for (u32 ppass = 0; ppass < PipelinePass_Count; ++ppass)
+            for (u32 geo = 0; geo < Geometry_Count; ++geo)
+            {
+                if (ppass == PipelinePass_Shaded)
+                    continue;
+                VKit::GraphicsPipeline &pipeline = gdata.Pipelines[samples][bpass][ppass][geo];
+                pipeline = Pipelines::CreateGeometryPipeline<D>(PipelinePass(ppass), BlendPass(bpass), Geometry(geo),
+                                                                vksamples);
 
-    rdata.Geometry.Pipelines.IterateMultiIndex([&](const u32 bpass, const u32 ppass, const u32 geo) {
-        rdata.Geometry.Pipelines[bpass][ppass][geo] =
-            Pipelines::CreateGeometryPipeline<D>(PipelinePass(ppass), BlendPass(bpass), Geometry(geo));
+                if (IsDebugUtilsEnabled())
+                {
+                    const TKit::StackString name = TKit::StackString::Format(
+                        "onyx-renderer-geometry-pipeline-{}D-{}x-{}-pass-{}-geometry-'{}'", u8(D), u32(vksamples),
+                        ToString(BlendPass(bpass)), ToString(PipelinePass(ppass)), ToString(Geometry(geo)));
 
+                    ONYX_CHECK_VKIT_RESULT(pipeline.SetName(name.CString()));
+                }
+            }
+    for (u32 geo = 0; geo < Geometry_Count; ++geo)
+    {
+        VKit::GraphicsPipeline &pipeline = gdata.PrepassPipelines[samples][geo];
+        pipeline = Pipelines::CreateDepthPrepassPipeline<D>(Geometry(geo), vksamples);
         if (IsDebugUtilsEnabled())
         {
-            const TKit::StackString name = TKit::StackString::Format(
-                "onyx-renderer-geometry-pipeline-{}D-{}-pass-{}-geometry-'{}'", u8(D), ToString(BlendPass(bpass)),
-                ToString(PipelinePass(ppass)), ToString(Geometry(geo)));
+            const TKit::StackString name =
+                TKit::StackString::Format("onyx-renderer-depth-prepass-pipeline-{}D-{}x-geometry-'{}'", u8(D),
+                                          u32(vksamples), ToString(Geometry(geo)));
+            ONYX_CHECK_VKIT_RESULT(pipeline.SetName(name.CString()));
+        }
+    }
+    gdata.HasPipelines[samples] = true;
+}
+
+template <Dimension D>
+static const ten<VKit::GraphicsPipeline, BlendPass_Count, PipelinePass_Count, Geometry_Count> &getGeometryPipelines(
+    const SampleCount samples)
+{
+    GeometryData &gdata = getRendererData<D>().Geometry;
+    if (!gdata.HasPipelines[samples])
+    {
+        TKIT_LOG_DEBUG("[ONYX][RENDERER] Creating {}D geometry pipelines for {}x multisampling", u8(D),
+                       u32(AsVulkanSampleCount(samples)));
+        createGeometryPipelines<D>(samples);
+    }
+    return gdata.Pipelines[samples];
+}
+
+template <Dimension D>
+static const ten<VKit::GraphicsPipeline, Geometry_Count> &getDepthPrepassPipelines(const SampleCount samples)
+{
+    getGeometryPipelines<D>(samples);
+    return getRendererData<D>().Geometry.PrepassPipelines[samples];
+}
+
+template <Dimension D> static void createShadedPipelines(const SampleCount samples, const ShadedFlags features)
+{
+    GeometryData &gdata = getRendererData<D>().Geometry;
+    const VkSampleCountFlagBits vksamples = AsVulkanSampleCount(samples);
+    const u32 variant = features & ShadedFlag_Specialized;
+    for (u32 bpass = 0; bpass < BlendPass_Count; ++bpass)
+        for (u32 geo = 0; geo < Geometry_Count; ++geo)
+        {
+            VKit::GraphicsPipeline &pipeline = gdata.ShadedPipelines[samples][variant][bpass][geo];
+            pipeline = Pipelines::CreateGeometryPipeline<D>(PipelinePass_Shaded, BlendPass(bpass), Geometry(geo),
+                                                            vksamples, variant);
+
+            if (IsDebugUtilsEnabled())
+            {
+                const TKit::StackString name = TKit::StackString::Format(
+                    "onyx-renderer-shaded-pipeline-{}D-{}x-variant-{}-{}-pass-geometry-'{}'", u8(D), u32(vksamples),
+                    variant, ToString(BlendPass(bpass)), ToString(Geometry(geo)));
 
-            ONYX_CHECK_VKIT_RESULT(rdata.Geometry.Pipelines[bpass][ppass][geo].SetName(name.CString()));
+                ONYX_CHECK_VKIT_RESULT(pipeline.SetName(name.CString()));
+            }
         }
-    });
+    gdata.HasShadedPipelines[samples][variant] = true;
+}
+
+template <Dimension D>
+static const ten<VKit::GraphicsPipeline, BlendPass_Count, Geometry_Count> &getShadedPipelines(
+    const SampleCount samples, const ShadedFlags features)
+{
+    GeometryData &gdata = getRendererData<D>().Geometry;
+    const u32 variant = features & ShadedFlag_Specialized;
+    if (!gdata.HasShadedPipelines[samples][variant])
+    {
+        TKIT_LOG_DEBUG("[ONYX][RENDERER] Creating {}D shaded pipelines for {}x multisampling and variant {}", u8(D),
+                       u32(AsVulkanSampleCount(samples)), variant);
+        createShadedPipelines<D>(samples, features);
+    }
+    return gdata.ShadedPipelines[samples][variant];
+}
+
+template <Dimension D> static void createPipelines()
+{
+    RendererData<D> &rdata = getRendererData<D>();
+    ShadowData<D> &sdata = rdata.Shadows;
+
+    // views have no shaded features enabled by default
+    createGeometryPipelines<D>(SampleCount_1);
+    createShadedPipelines<D>(SampleCount_1, 0);
 
     for (u32 geo = 0; geo < Geometry_Count; ++geo)
     {
@@ -555,6 +787,16 @@ template <Dimension D> static void createPipelines()
                                                                      u8(D), ToString(Geometry(geo)));
             ONYX_CHECK_VKIT_RESULT(sdata.Pipelines[geo].SetName(name.CString()));
         }
+        if constexpr (D == D3)
+        {
+            sdata.PointPipelines[geo] = Pipelines::CreateShadowPipeline<D3>(Geometry(geo), format, s_CubeFaceViewMask);
+            if (IsDebugUtilsEnabled())
+            {
+                const TKit::StackString name = TKit::StackString::Format(
+                    "onyx-renderer-point-shadow-pipeline-3D-geometry-'{}'", ToString(Geometry(geo)));
+                ONYX_CHECK_VKIT_RESULT(sdata.PointPipelines[geo].SetName(name.CString()));
+            }
+        }
     }
 
     if constexpr (D == D2)
@@ -572,12 +814,16 @@ static void createPipelines()
     s_BlendPipeline = Pipelines::CreateBlendPipeline();
     s_PostProcessPipeline = Pipelines::CreatePostProcessPipeline();
     s_CompositorPipeline = Pipelines::CreateCompositorPipeline();
+    s_LightCullPipeline = Pipelines::CreateLightCullPipeline();
+    s_DepthReducePipeline = Pipelines::CreateDepthReducePipeline();
 
     if (IsDebugUtilsEnabled())
     {
         ONYX_CHECK_VKIT_RESULT(s_BlendPipeline.SetName("onyx-blend-pipeline"));
         ONYX_CHECK_VKIT_RESULT(s_PostProcessPipeline.SetName("onyx-post-process-pipeline"));
         ONYX_CHECK_VKIT_RESULT(s_CompositorPipeline.SetName("onyx-compositor-pipeline"));
+        ONYX_CHECK_VKIT_RESULT(s_LightCullPipeline.SetName("onyx-light-cull-pipeline"));
+        ONYX_CHECK_VKIT_RESULT(s_DepthReducePipeline.SetName("onyx-depth-reduce-pipeline"));
     }
 
     createPipelines<D2>();
@@ -590,10 +836,21 @@ template <Dimension D> static void destroyPipelines()
     ShadowData<D> &sdata = rdata.Shadows;
     for (VKit::GraphicsPipeline &p : rdata.Geometry.Pipelines)
         p.Destroy();
+    for (VKit::GraphicsPipeline &p : rdata.Geometry.ShadedPipelines)
+        p.Destroy();
+    for (VKit::GraphicsPipeline &p : rdata.Geometry.PrepassPipelines)
+        p.Destroy();
+    for (bool &created : rdata.Geometry.HasPipelines)
+        created = false;
+    for (bool &created : rdata.Geometry.HasShadedPipelines)
+        created = false;
     for (VKit::GraphicsPipeline &p : sdata.Pipelines)
         p.Destroy();
     if constexpr (D == D2)
         sdata.RayMarchPipeline.Destroy();
+    else
+        for (VKit::GraphicsPipeline &p : sdata.PointPipelines)
+            p.Destroy();
 }
 
 static void destroyPipelines()
@@ -603,6 +860,8 @@ static void destroyPipelines()
     s_BlendPipeline.Destroy();
     s_PostProcessPipeline.Destroy();
     s_CompositorPipeline.Destroy();
+    s_LightCullPipeline.Destroy();
+    s_DepthReducePipeline.Destroy();
 }
 
 template <Dimension D> static void initializeLights()
@@ -715,6 +974,19 @@ template <Dimension D> static void initialize(const ShadowSpecs<D> &shadowSpecs)
     igpool.Buffer = createGraphicsIndexBuffer<D>();
     igpool.Ranges.Append(GraphicsRange{.Size = igpool.Buffer.GetInfo().Size});
 
+    for (u32 i = 0; i < ContextTable_Count; ++i)
+    {
+        const ContextTable table = ContextTable(i);
+        Arena &arena = rdata.TableArenas[table];
+
+        arena.Transfer.Buffer = createTransferTableBuffer<D>(table);
+        arena.Transfer.Ranges.Append(TransferRange{.Size = arena.Transfer.Buffer.GetInfo().Size});
+
+        arena.Graphics.Buffer = createGraphicsTableBuffer<D>(table);
+        arena.Graphics.Ranges.Append(GraphicsRange{.Size = arena.Graphics.Buffer.GetInfo().Size});
+        updateTableDescriptorSets<D>(table);
+    }
+
     initializeLights<D>();
     return initializeShadows(shadowSpecs);
 }
@@ -750,6 +1022,11 @@ template <Dimension D> static void terminate()
     rdata.Geometry.VertexArena.Transfer.Buffer.Destroy();
     rdata.Geometry.IndexArena.Graphics.Buffer.Destroy();
     rdata.Geometry.IndexArena.Transfer.Buffer.Destroy();
+    for (Arena &arena : rdata.TableArenas)
+    {
+        arena.Graphics.Buffer.Destroy();
+        arena.Transfer.Buffer.Destroy();
+    }
 
     terminateShadows<D>();
 
@@ -778,6 +1055,12 @@ void Initialize(const Specs &specs)
     s_NearSampler = ONYX_CHECK_VKIT_RESULT(
         VKit::Sampler::Builder(GetDevice()).SetMinFilter(VK_FILTER_NEAREST).SetMagFilter(VK_FILTER_NEAREST).Build());
 
+    s_UpscaleSampler = ONYX_CHECK_VKIT_RESULT(VKit::Sampler::Builder(GetDevice())
+                                                  .SetMinFilter(VK_FILTER_LINEAR)
+                                                  .SetMagFilter(VK_FILTER_LINEAR)
+                                                  .SetAddressModes(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE)
+                                                  .Build());
+
     s_CompareSampler = ONYX_CHECK_VKIT_RESULT(VKit::Sampler::Builder(GetDevice())
                                                   .SetMinFilter(VK_FILTER_LINEAR)
                                                   .SetMagFilter(VK_FILTER_LINEAR)
@@ -791,9 +1074,12 @@ void Initialize(const Specs &specs)
     {
         ONYX_CHECK_VKIT_RESULT(s_LinearSampler.SetName("onyx-linear-sampler"));
         ONYX_CHECK_VKIT_RESULT(s_NearSampler.SetName("onyx-near-sampler"));
+        ONYX_CHECK_VKIT_RESULT(s_UpscaleSampler.SetName("onyx-upscale-sampler"));
         ONYX_CHECK_VKIT_RESULT(s_CompareSampler.SetName("onyx-compare-sampler"));
     }
 
+    s_QuantizedStaticMeshes = specs.QuantizeStaticMeshes;
+    s_DirectInstanceWrites = specs.DirectInstanceWrites && IsDeviceLocalHostVisible();
     initialize<D2>(specs.Shadows2);
     initialize<D3>(specs.Shadows3);
     return createPipelines();
@@ -811,6 +1097,7 @@ void Terminate()
         buffer.Buffer.Destroy();
     s_LinearSampler.Destroy();
     s_NearSampler.Destroy();
+    s_UpscaleSampler.Destroy();
     s_CompareSampler.Destroy();
     s_RendererData2.Destruct();
     s_RendererData3.Destruct();
@@ -845,17 +1132,18 @@ template <Dimension D> void DestroyContext(const RenderContext<D> *context)
 {
     RendererData<D> &rdata = getRendererData<D>();
     const u32 index = getContextIndex(context);
+    markViewsChanged(rdata.Contexts[index].Views | context->GetViewMask());
     for (InstanceArena &arena : rdata.Geometry.Arenas)
         for (GraphicsInstanceRange &grange : arena.Graphics.Ranges)
         {
-            ViewMask vmask = 0;
+            ViewMask vmask{};
             for (ContextInstanceRange &crange : grange.ContextRanges)
             {
                 if (crange.ContextIndex != TKIT_U32_MAX && crange.ContextIndex > index)
                     --crange.ContextIndex;
                 else if (crange.ContextIndex == index)
                 {
-                    crange.ViewMask = 0;
+                    crange.ViewMask = {};
                     crange.ContextIndex = TKIT_U32_MAX;
                 }
                 vmask |= crange.ViewMask;
@@ -891,26 +1179,30 @@ bool IsDepthSupportedFor2D()
 {
     return !s_RendererData2->Shadows.UsesFallback;
 }
+bool HasQuantizedStaticMeshes()
+{
+    return s_QuantizedStaticMeshes;
+}
 
-template <Dimension D> static void addTarget(const ViewMask vmask)
+template <Dimension D> static void addTarget(const ViewMask &vmask)
 {
     RendererData<D> &rdata = getRendererData<D>();
     for (const ContextInfo<D> &info : rdata.Contexts)
         info.Context->AddTarget(vmask);
 }
-template <Dimension D> static void removeTarget(const ViewMask vmask)
+template <Dimension D> static void removeTarget(const ViewMask &vmask)
 {
     RendererData<D> &rdata = getRendererData<D>();
     for (const ContextInfo<D> &info : rdata.Contexts)
         info.Context->RemoveTarget(vmask);
 }
 
-void AddTarget(const ViewMask vmask)
+void AddTarget(const ViewMask &vmask)
 {
     addTarget<D2>(vmask);
-    addTarget<D2>(vmask);
+    addTarget<D3>(vmask);
 }
-void RemoveTarget(const ViewMask vmask)
+void RemoveTarget(const ViewMask &vmask)
 {
     removeTarget<D2>(vmask);
     removeTarget<D3>(vmask);
@@ -935,6 +1227,10 @@ const VKit::Sampler &GetNearSampler()
 {
     return s_NearSampler;
 }
+const VKit::Sampler &GetUpscaleSampler()
+{
+    return s_UpscaleSampler;
+}
 
 template <Dimension D> const ten<VkDescriptorSet, Geometry_Count> &GetDescriptorSets(const RenderPass pass)
 {
@@ -995,15 +1291,16 @@ static void validateGraphicsInstanceRanges(const GraphicsInstancePool &gpool)
         }
         const auto &cranges = grange.ContextRanges;
         VkDeviceSize csize = 0;
-        ViewMask vmask = 0;
+        ViewMask vmask{};
         for (u32 j = 0; j < cranges.GetSize(); ++j)
         {
             const ContextInstanceRange &crange = cranges[j];
             TKIT_ASSERT(
-                (crange.ViewMask & grange.ViewMask) || crange.ViewMask == grange.ViewMask || crange.ViewMask == 0,
+                (crange.ViewMask & grange.ViewMask) || crange.ViewMask == grange.ViewMask || !crange.ViewMask,
                 "[ONYX][RENDERER] A context memory range with index {} ({} total) has one or more view bits not "
-                "present in graphics range view mask (context range has {:032b} while graphics range has {:032b})",
-                i, cranges.GetSize(), crange.ViewMask, grange.ViewMask);
+                "present in graphics range view mask (context range has {} while graphics range has {})", i,
+                cranges.GetSize(), formatViewMask(crange.ViewMask).CString(),
+                formatViewMask(grange.ViewMask).CString());
 
             vmask |= crange.ViewMask;
             TKIT_ASSERT(
@@ -1037,9 +1334,9 @@ static void validateGraphicsInstanceRanges(const GraphicsInstancePool &gpool)
             csize += crange.Size;
         }
         TKIT_ASSERT(vmask == grange.ViewMask,
-                    "[ONYX][RENDERER] Combined context range viewmasks ({:032b}) does not match the view mask of "
-                    "the graphics range ({:032b})",
-                    vmask, grange.ViewMask);
+                    "[ONYX][RENDERER] Combined context range viewmasks ({}) does not match the view mask of the "
+                    "graphics range ({})",
+                    formatViewMask(vmask).CString(), formatViewMask(grange.ViewMask).CString());
 
         TKIT_ASSERT(csize <= grange.Size,
                     "[ONYX][RENDERER] The sum of the context memory range sizes ({:L}) exceeds the size of its "
@@ -1069,6 +1366,12 @@ template <Dimension D> static void validateRanges()
     validateRanges("transfer index", rdata.Geometry.IndexArena.Transfer);
     validateRanges("graphics index", rdata.Geometry.IndexArena.Graphics);
 
+    validateRanges("transfer clip", rdata.TableArenas[ContextTable_Clips].Transfer);
+    validateRanges("graphics clip", rdata.TableArenas[ContextTable_Clips].Graphics);
+
+    validateRanges("transfer attribute", rdata.TableArenas[ContextTable_Attributes].Transfer);
+    validateRanges("graphics attribute", rdata.TableArenas[ContextTable_Attributes].Graphics);
+
     const LightData<D> &ldata = rdata.Lights;
     for (const LightArena &arena : ldata.Arenas)
     {
@@ -1181,7 +1484,7 @@ static Range *splitRange(const u32 index, TKit::TierArray<Range> &ranges, const
     range.Size -= requiredMem;
     if constexpr (std::is_same_v<Range, GraphicsInstanceRange>)
     {
-        range.ViewMask = 0;
+        range.ViewMask = {};
         range.MeshHandle = NullHandle;
         range.RenderFlags = 0;
         range.ContextRanges.Clear();
@@ -1260,6 +1563,21 @@ static TransferRange *findTransferIndexRange(TransferLightPool &pool, const VkDe
         true);
 }
 
+// tables of earlier contexts stay staged in the pool until the copies are recorded, and attribute tables are rebased in
+// place after being written, so growing the pool has to carry every table over
+template <Dimension D>
+static TransferRange *findTransferTableRange(const ContextTable table, TransferPool &pool,
+                                             const VkDeviceSize requiredMem)
+{
+    return findTransferRange<D, TransferRange>(
+        pool, requiredMem,
+        [&] {
+            return createTransferTableBuffer<D>(
+                table, computeNewInstanceCount(getTableElementSize<D>(table), pool.Buffer, requiredMem));
+        },
+        true);
+}
+
 template <Dimension D, typename Range, typename Pool, typename F1, typename F2>
 static Range *findGraphicsRange(Pool &pool, const VkDeviceSize requiredMem, const F1 createBuffer,
                                 const F2 canRangeSplit, bool *resized = nullptr, const bool copyOldContents = false,
@@ -1355,6 +1673,27 @@ GraphicsRange *findGraphicsIndexRange(GraphicsPool &pool, const VkDeviceSize req
         nullptr, true, transfer);
 }
 
+// the tables of contexts that did not upload them again must stay where they are, so ranges still referenced by one
+// cannot be reused
+template <Dimension D>
+static GraphicsRange *findGraphicsTableRange(const ContextTable table, GraphicsPool &pool,
+                                             const VkDeviceSize requiredMem, VKit::Queue *transfer)
+{
+    const RendererData<D> &rdata = getRendererData<D>();
+    bool resized = false;
+    GraphicsRange *range = findGraphicsRange<D, GraphicsRange>(
+        pool, requiredMem,
+        [&] {
+            return createGraphicsTableBuffer<D>(
+                table, computeNewInstanceCount(getTableElementSize<D>(table), pool.Buffer, requiredMem));
+        },
+        [&](const GraphicsRange &range) { return !rdata.IsTableRangeReferenced(table, range); }, &resized, true,
+        transfer);
+    if (resized)
+        updateTableDescriptorSets<D>(table);
+    return range;
+}
+
 static VkBufferMemoryBarrier2KHR createAcquireBarrier(const VkBuffer deviceLocalBuffer, const VkDeviceSize offset,
                                                       const VkDeviceSize size)
 {
@@ -1367,7 +1706,8 @@ static VkBufferMemoryBarrier2KHR createAcquireBarrier(const VkBuffer deviceLocal
     barrier.srcAccessMask = needsTransfer ? VK_ACCESS_2_NONE_KHR : VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
     barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT_KHR;
     barrier.srcStageMask = needsTransfer ? VK_PIPELINE_STAGE_2_NONE_KHR : VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
-    barrier.dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR;
+    // light buffers are also read by the light culling compute pass, which runs before any vertex work of the view
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
 
     barrier.srcQueueFamilyIndex = needsTransfer ? qsrc : VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = needsTransfer ? qdst : VK_QUEUE_FAMILY_IGNORED;
@@ -1518,24 +1858,29 @@ static Range findAvailableTextureMapRange(const LightType light, const VkFormat
             const u32 lcount = lcounts[light];
 
             builder.SetArrayLayers(lcount);
-            for (u32 j = 0; j < lcount; ++j)
-            {
-                VkImageSubresourceRange rg{};
-                rg.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-                rg.baseArrayLayer = j;
-                rg.layerCount = 1;
-                rg.levelCount = 1;
-                builder.AddImageView(rg);
-            }
             if (light == Light_Point)
             {
+                // the multiview pass renders to an array view spanning every face
                 builder.SetFlags(VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
+                builder.AddImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY);
                 builder.AddImageView(VK_IMAGE_VIEW_TYPE_CUBE);
             }
-            else if (light == Light_Directional)
-                builder.AddImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY);
             else
-                builder.AddImageView();
+            {
+                for (u32 j = 0; j < lcount; ++j)
+                {
+                    VkImageSubresourceRange rg{};
+                    rg.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+                    rg.baseArrayLayer = j;
+                    rg.layerCount = 1;
+                    rg.levelCount = 1;
+                    builder.AddImageView(rg);
+                }
+                if (light == Light_Directional)
+                    builder.AddImageView(VK_IMAGE_VIEW_TYPE_2D_ARRAY);
+                else
+                    builder.AddImageView();
+            }
         }
 
         map.Image = ONYX_CHECK_VKIT_RESULT(builder.Build());
@@ -1575,7 +1920,7 @@ static Range findAvailableTextureMapRange(const LightType light, const VkFormat
 }
 
 template <Dimension D>
-PointLightData<D> createLightData(const ViewMask vmask, const u32 shadowMapOffset,
+PointLightData<D> createLightData(const ViewMask &vmask, const u32 shadowMapOffset,
                                   const PointLightParameters<D> &params)
 {
     PointLightData<D> data;
@@ -1630,7 +1975,8 @@ static TKit::FixedArray<CascadeData, ONYX_MAX_CASCADES> createCascades(const f32
     return cascades;
 }
 
-static TKit::FixedArray8<f32v4> getCameraCorners(const f32m4 &pv)
+// corners are ordered so that each near corner is followed by its far counterpart. depths are given in ndc
+static TKit::FixedArray8<f32v4> getCameraCorners(const f32m4 &pv, const f32 nearDepth, const f32 farDepth)
 {
     const f32m4 ipv = Math::Inverse(pv);
     TKit::FixedArray8<f32v4> corners;
@@ -1639,7 +1985,7 @@ static TKit::FixedArray8<f32v4> getCameraCorners(const f32m4 &pv)
         for (u32 j = 0; j < 2; ++j)
             for (u32 k = 0; k < 2; ++k)
             {
-                const f32v4 norm = f32v4{2.f * i - 1.f, 2.f * j - 1.f, f32(k), 1.f};
+                const f32v4 norm = f32v4{2.f * i - 1.f, 2.f * j - 1.f, k == 0 ? nearDepth : farDepth, 1.f};
                 const f32v4 wpos = ipv * norm;
                 corners[idx++] = wpos / wpos[3];
             }
@@ -1652,8 +1998,6 @@ static TKit::FixedArray<CascadeData, ONYX_MAX_CASCADES> createCascades(const f32
                                                                        const f32 lambda, const f32 overlap,
                                                                        u32 &enableFlags)
 {
-    const TKit::FixedArray8<f32v4> globalCorners = getCameraCorners(rview->GetProjectionView());
-
     TKit::FixedArray<CascadeData, ONYX_MAX_CASCADES> cascades;
     f32 cnear;
     f32 cfar;
@@ -1669,6 +2013,30 @@ static TKit::FixedArray<CascadeData, ONYX_MAX_CASCADES> createCascades(const f32
         cnear = camera->OrthoParameters.Near;
         cfar = camera->OrthoParameters.Far;
     }
+
+    // reversed depth projections have no far plane. the cascades then cover up to the far parameter, which lies at a
+    // depth of near / far
+    const f32m4 &pv = rview->GetProjectionView();
+    f32v2 depths = rview->HasReversedDepth() ? f32v2{1.f, cnear / cfar} : f32v2{0.f, 1.f};
+
+    // when the view samples its depth buffer, the cascades only need to cover the depth range that was visible.
+    // the split distances are then measured from the camera to the centers of the sampled near and far planes, the same
+    // way the shaders measure fragment depths
+    const bool sampled = rview->GetSampledDepthRange(depths);
+    const TKit::FixedArray8<f32v4> globalCorners = getCameraCorners(pv, depths[0], depths[1]);
+    if (sampled)
+    {
+        const f32v3 &position = camera->View.Translation;
+        const f32v3 forward = Math::Normalize(camera->View.Rotation) * f32v3{0.f, 0.f, -1.f};
+        const auto planeDistance = [&](const u32 side) {
+            f32v3 center{0.f};
+            for (u32 j = 0; j < 4; ++j)
+                center += f32v3{globalCorners[2 * j + side]};
+            return Math::Dot(0.25f * center - position, forward);
+        };
+        cnear = planeDistance(0);
+        cfar = Math::Max(planeDistance(1), cnear + 0.01f);
+    }
     const f32 range = cfar - cnear;
     f32 split0 = cnear;
     enableFlags = 0;
@@ -1742,7 +2110,7 @@ static TKit::FixedArray<CascadeData, ONYX_MAX_CASCADES> createCascades(const f32
 }
 
 template <Dimension D>
-DirectionalLightData<D> createLightData(const ViewMask vmask, const u32 shadowMapOffset,
+DirectionalLightData<D> createLightData(const ViewMask &vmask, const u32 shadowMapOffset,
                                         const DirectionalLightParameters<D> &params)
 {
     DirectionalLightData<D> data;
@@ -1804,7 +2172,7 @@ DirectionalLightData<D> createLightData(const ViewMask vmask, const u32 shadowMa
     return data;
 }
 
-SpotLightData createLightData(const ViewMask vmask, const u32 shadowMapOffset, const SpotLightParameters &params)
+SpotLightData createLightData(const ViewMask &vmask, const u32 shadowMapOffset, const SpotLightParameters &params)
 {
     SpotLightData data;
     data.Direction = Math::Normalize(params.Direction);
@@ -1834,6 +2202,51 @@ SpotLightData createLightData(const ViewMask vmask, const u32 shadowMapOffset, c
     return data;
 }
 
+// instances store the index of their attributes within the table of their context, and attributes the index of their
+// clip rect. the rebased index is read from the host copy of the elements and written straight to the staging buffer
+// they were just copied to. null clip indices are left untouched
+static void rebaseTableIndices(VKit::DeviceBuffer &buffer, const VkDeviceSize offset, const void *data,
+                               const u32 elements, const usz stride, const usz member, const u32 tableOffset)
+{
+    const std::byte *src = scast<const std::byte *>(data) + member;
+    std::byte *dst = scast<std::byte *>(buffer.GetData()) + offset + member;
+    for (u32 i = 0; i < elements; ++i)
+    {
+        u32 index;
+        std::memcpy(&index, src + i * stride, sizeof(u32));
+        if (index == ONYX_NULL_CLIP_RECT)
+            continue;
+
+        index += tableOffset;
+        std::memcpy(dst + i * stride, &index, sizeof(u32));
+    }
+}
+
+// copies whose source and destination both continue the ones of the previous copy are folded into it, so that adjacent
+// ranges of the same pool are copied as a single region. the regions of a copy command never overlap, so they can be
+// sorted freely. returns the number of copies left
+static u32 mergeBufferCopies(VkBufferCopy2KHR *copies, const u32 count)
+{
+    if (count == 0)
+        return 0;
+
+    std::sort(copies, copies + count, [](const VkBufferCopy2KHR &lhs, const VkBufferCopy2KHR &rhs) {
+        return lhs.dstOffset < rhs.dstOffset;
+    });
+
+    u32 merged = 0;
+    for (u32 i = 1; i < count; ++i)
+    {
+        VkBufferCopy2KHR &last = copies[merged];
+        const VkBufferCopy2KHR &copy = copies[i];
+        if (last.srcOffset + last.size == copy.srcOffset && last.dstOffset + last.size == copy.dstOffset)
+            last.size += copy.size;
+        else
+            copies[++merged] = copy;
+    }
+    return merged + 1;
+}
+
 template <Dimension D>
 static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, TransferSubmitInfo &info,
                      TKit::StackArray<VkBufferMemoryBarrier2KHR> *release, const u64 transferFlightValue,
@@ -1878,12 +2291,18 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
 
         const ViewMask vmask = ctx->GetViewMask();
         if (!vmask)
+        {
+            markViewsChanged(cinfo.Views);
+            cinfo.Views = {};
             continue;
+        }
 
         const bool isDirty = cinfo.IsDirty();
         if (isDirty)
         {
             dirtyContexts.Append(i);
+            markViewsChanged(vmask | cinfo.Views);
+            cinfo.Views = vmask;
 
             const ContextInstanceData *idata = ctx->GetInstanceData();
             ForEachResourceGroup<D>([&](const u32 bpass, const u32 rmode, const u32 mtype, const u32 pid) {
@@ -1917,7 +2336,8 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
                             ((flags & LightFlag_CastShadows) *
                              (LightUpdateFlag_Point | LightUpdateFlag_Directional | LightUpdateFlag_Spot));
 
-                sdata.DirtyShadowViews |= vmask * (flags & LightFlag_CastShadows);
+                if (flags & LightFlag_CastShadows)
+                    sdata.DirtyShadowViews |= vmask;
             };
 
         gatherLights(Light_Point, ctx->GetPointLightData(), ldata.Instances.Points.Lights, LightUpdateFlag_Point);
@@ -1961,8 +2381,7 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
         {
             const LightParams &light = clights.Lights[i];
 
-            const ViewMask vm = vmasks[i];
-            const u32 count = std::popcount(vm);
+            const u32 count = vmasks[i].GetCount();
             u32 shadowOffset = TKIT_U32_MAX;
 
             if (light.Flags & LightFlag_CastShadows)
@@ -2021,30 +2440,24 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
         VkDeviceSize RequiredMemory;
     };
 
-    // the actual copy commands for each data type (instance, vertex and index). can belong to any buffer (in the case
-    // of vertex/index there is only one buffer for each so its easy enough)
+    // the actual copy commands for each data type (instance, vertex, index and context tables). there is one pair of
+    // transfer-graphics buffers per geometry type and context table, and a single one for vertices and indices. all
+    // copies to the same buffer are recorded in a single command once merged
     struct BufferCopies
     {
-        BufferCopies(const u32 incount, const u32 dynCount)
+        BufferCopies(const u32 incount, const u32 dynCount, const u32 tableCount)
         {
-            Instance.Reserve(incount);
+            for (TKit::StackArray<VkBufferCopy2KHR> &copies : Instance)
+                copies.Reserve(incount);
             Vertex.Reserve(dynCount);
             Index.Reserve(dynCount);
+            for (TKit::StackArray<VkBufferCopy2KHR> &copies : Tables)
+                copies.Reserve(tableCount);
         }
-        TKit::StackArray<VkBufferCopy2KHR> Instance{};
+        TKit::FixedArray<TKit::StackArray<VkBufferCopy2KHR>, Geometry_Count> Instance{};
         TKit::StackArray<VkBufferCopy2KHR> Vertex{};
         TKit::StackArray<VkBufferCopy2KHR> Index{};
-    };
-
-    // a "copy struct slice" to identify what chunks of the global copy array belongs to which instance buffer, as there
-    // are many (one pair transfer-graphics per geometry type). this is only needed for instances. for v/i, there is
-    // only one buffer so all copies go to those
-    struct BufferCopySlice
-    {
-        VKit::DeviceBuffer *Transfer;
-        VKit::DeviceBuffer *Graphics;
-        u32 Offset;
-        u32 Size;
+        TKit::FixedArray<TKit::StackArray<VkBufferCopy2KHR>, ContextTable_Count> Tables{};
     };
 
     const u32 bcount = Resources::GetDistinctBatchDrawCount<D>();
@@ -2052,13 +2465,87 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
     const u32 upperCapacity =
         dirtyContexts.GetSize() * bcount * u32(RenderMode_Count) * u32(BlendPass_Count) * u32(Geometry_Count);
 
-    BufferCopies copies{upperCapacity, dynCount};
+    BufferCopies copies{upperCapacity / u32(Geometry_Count), dynCount, dirtyContexts.GetSize()};
 
     TKit::StackArray<RangePair> ranges{};
-    ranges.Reserve(upperCapacity);
+    ranges.Reserve(upperCapacity + ContextTable_Count * dirtyContexts.GetSize());
+
+    // where the host data of a table was written to, so that the indices it holds can be rebased in place
+    struct WrittenRange
+    {
+        VKit::DeviceBuffer *Buffer = nullptr;
+        VkDeviceSize Offset = 0;
+    };
+
+    const auto uploadTable = [&](ContextInfo<D> &cinfo, const ContextTable table, const void *data,
+                                 const u32 count) -> WrittenRange {
+        ContextTableRange &tinfo = cinfo.Tables[table];
+        tinfo = {};
+        tinfo.Count = count;
+        if (count == 0)
+            return {};
+
+        Arena &arena = rdata.TableArenas[table];
+        const u32 elementSize = getTableElementSize<D>(table);
+        const VkDeviceSize requiredMem = count * elementSize;
+
+        TransferRange *trange = nullptr;
+        if (!s_DirectInstanceWrites)
+        {
+            trange = findTransferTableRange<D>(table, arena.Transfer, requiredMem);
+            trange->Tracker.MarkInUse(transfer, transferFlightValue);
+            arena.Transfer.Buffer.Write(data, {.srcOffset = 0, .dstOffset = trange->Offset, .size = requiredMem});
+        }
+
+        GraphicsRange *grange = findGraphicsTableRange<D>(table, arena.Graphics, requiredMem, transfer);
+        grange->GraphicsTracker = {};
+        grange->Generation = ++arena.LatestGeneration;
+
+        tinfo.Generation = grange->Generation;
+        tinfo.Offset = u32(grange->Offset / elementSize);
+        if (s_DirectInstanceWrites)
+        {
+            arena.Graphics.Buffer.Write(data, {.srcOffset = 0, .dstOffset = grange->Offset, .size = requiredMem});
+            return WrittenRange{&arena.Graphics.Buffer, grange->Offset};
+        }
+        grange->TransferTracker.MarkInUse(transfer, transferFlightValue);
+
+        VkBufferCopy2KHR &copy = copies.Tables[table].Append();
+        copy.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2_KHR;
+        copy.pNext = nullptr;
+        copy.srcOffset = trange->Offset;
+        copy.dstOffset = grange->Offset;
+        copy.size = requiredMem;
+        ranges.Append(&arena.Graphics.Buffer, grange->Offset, requiredMem);
+        return WrittenRange{&arena.Transfer.Buffer, trange->Offset};
+    };
 
-    TKit::StackArray<BufferCopySlice> instanceCopyCmds{};
-    instanceCopyCmds.Reserve(upperCapacity);
+    // instances are split in a transform stream and a deduplicated attribute table. a dirty context only uploads its
+    // clip and attribute tables when they changed since its last upload, and the indices into them are rebased by the
+    // offsets of their ranges as they are written to the staging buffers. contexts whose instances only moved keep
+    // referencing the tables they uploaded last, so only their transforms are transferred
+    for (const u32 idx : dirtyContexts)
+    {
+        ContextInfo<D> &cinfo = contexts[idx];
+        const RenderContext<D> *ctx = cinfo.Context;
+
+        const TKit::TierArray<WorldRect<D>> &rects = ctx->GetClipRects();
+        const TKit::TierArray<InstanceAttributes> &attributes = ctx->GetInstanceData()->Attributes;
+        if (ctx->GetAttributeGeneration() == cinfo.AttributeGeneration &&
+            rects.GetSize() == cinfo.Tables[ContextTable_Clips].Count &&
+            attributes.GetSize() == cinfo.Tables[ContextTable_Attributes].Count)
+            continue;
+
+        cinfo.AttributeGeneration = ctx->GetAttributeGeneration();
+        uploadTable(cinfo, ContextTable_Clips, rects.GetData(), rects.GetSize());
+        const WrittenRange written =
+            uploadTable(cinfo, ContextTable_Attributes, attributes.GetData(), attributes.GetSize());
+
+        const u32 clipOffset = cinfo.Tables[ContextTable_Clips].Offset;
+        if (written.Buffer && clipOffset != 0)
+            rebaseTableIndices(*written.Buffer, written.Offset, attributes.GetData(), attributes.GetSize(),
+                               sizeof(InstanceAttributes), offsetof(InstanceAttributes, ClipIndex), clipOffset);
+    }
 
     TKit::StackArray<ContextInstanceRange> contextRanges{};
     contextRanges.Reserve(dirtyContexts.GetSize());
@@ -2118,7 +2605,7 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
 
         contextRanges.Clear();
         VkDeviceSize requiredMem = 0;
-        ViewMask viewMask = 0;
+        ViewMask viewMask{};
         for (const u32 idx : dirtyContexts)
         {
             const RenderContext<D> *ctx = rdata.Contexts[idx].Context;
@@ -2141,16 +2628,28 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
         if (requiredMem == 0)
             return;
 
-        TransferInstanceRange *trange = findTransferInstanceRange<D>(Geometry(geo), tpool, requiredMem);
-        trange->Tracker.MarkInUse(transfer, transferFlightValue);
+        const auto writeContextRanges = [&](VKit::DeviceBuffer &buffer, const VkDeviceSize offset) {
+            for (const ContextInstanceRange &crange : contextRanges)
+            {
+                const RenderContext<D> *ctx = contexts[crange.ContextIndex].Context;
 
-        for (const ContextInstanceRange &crange : contextRanges)
-        {
-            const RenderContext<D> *ctx = contexts[crange.ContextIndex].Context;
+                const auto &idata = getInstanceData(ctx);
+                buffer.Write(idata.Data.GetData(),
+                             {.srcOffset = 0, .dstOffset = offset + crange.Offset, .size = crange.Size});
 
-            const auto &idata = getInstanceData(ctx);
-            tpool.Buffer.Write(idata.Data.GetData(),
-                               {.srcOffset = 0, .dstOffset = trange->Offset + crange.Offset, .size = crange.Size});
+                const u32 attributeOffset = contexts[crange.ContextIndex].Tables[ContextTable_Attributes].Offset;
+                if (attributeOffset != 0)
+                    rebaseTableIndices(buffer, offset + crange.Offset, idata.Data.GetData(), idata.Instances,
+                                       idata.InstanceSize, offsetof(InstanceData<D>, AttributeIndex), attributeOffset);
+            }
+        };
+
+        TransferInstanceRange *trange = nullptr;
+        if (!s_DirectInstanceWrites)
+        {
+            trange = findTransferInstanceRange<D>(Geometry(geo), tpool, requiredMem);
+            trange->Tracker.MarkInUse(transfer, transferFlightValue);
+            writeContextRanges(tpool.Buffer, trange->Offset);
         }
 
         GraphicsInstanceRange *grange = findGraphicsInstanceRange<D>(Geometry(geo), gpool, requiredMem, transfer);
@@ -2159,7 +2658,6 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
         grange->ContextRanges = contextRanges;
         grange->ViewMask = viewMask;
         grange->RenderFlags = GetRenderModeFlags(RenderMode(rmode));
-        grange->TransferTracker.MarkInUse(transfer, transferFlightValue);
         grange->GraphicsTracker = {};
         if (geo == Geometry_Dynamic)
         {
@@ -2167,7 +2665,17 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
             grange->ActiveIndexGeneration = igen;
         }
 
-        VkBufferCopy2KHR &copy = copies.Instance.Append();
+        // host visible graphics ranges are written in place. they are never in use by the device when handed out, and
+        // host writes are made visible to it by the submission that reads them once flushed, so no copy nor barrier is
+        // needed
+        if (s_DirectInstanceWrites)
+        {
+            writeContextRanges(gpool.Buffer, grange->Offset);
+            return;
+        }
+        grange->TransferTracker.MarkInUse(transfer, transferFlightValue);
+
+        VkBufferCopy2KHR &copy = copies.Instance[geo].Append();
         copy.sType = VK_STRUCTURE_TYPE_BUFFER_COPY_2_KHR;
         copy.pNext = nullptr;
         copy.srcOffset = trange->Offset;
@@ -2179,14 +2687,6 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
 
     const auto gatherInstanceRanges = [&](const u32 rmode, const u32 geo) {
         TKIT_PROFILE_NSCOPE("Onyx::Renderer::FindRanges");
-        TransferInstancePool &tpool = rdata.Geometry.Arenas[geo].Transfer;
-        GraphicsInstancePool &gpool = rdata.Geometry.Arenas[geo].Graphics;
-
-        BufferCopySlice copyCmdSlice{};
-        copyCmdSlice.Transfer = &tpool.Buffer;
-        copyCmdSlice.Graphics = &gpool.Buffer;
-        copyCmdSlice.Offset = copies.Instance.GetSize();
-
         if (geo == Geometry_Circle)
             for (u32 bpass = 0; bpass < BlendPass_Count; ++bpass)
                 findInstanceRanges(rmode, bpass, Geometry_Circle, NullHandle,
@@ -2221,36 +2721,66 @@ static void transfer(VKit::Queue *transfer, const VkCommandBuffer command, Trans
                 }
             }
         }
-
-        copyCmdSlice.Size = copies.Instance.GetSize() - copyCmdSlice.Offset;
-        if (copyCmdSlice.Size != 0)
-            instanceCopyCmds.Append(copyCmdSlice);
     };
 
     for (u32 rmode = 0; rmode < RenderMode_Count; ++rmode)
         for (u32 geo = 0; geo < Geometry_Count; ++geo)
             gatherInstanceRanges(rmode, geo);
 
-    for (const RangePair &range : ranges)
+    // ranges are mostly carved out of the pools one after the other, so their barriers are merged the same way their
+    // copies are
+    std::sort(ranges.begin(), ranges.end(), [](const RangePair &lhs, const RangePair &rhs) {
+        if (lhs.GraphicsBuffer != rhs.GraphicsBuffer)
+            return std::less<const VKit::DeviceBuffer *>{}(lhs.GraphicsBuffer, rhs.GraphicsBuffer);
+        return lhs.GraphicsOffset < rhs.GraphicsOffset;
+    });
+    for (u32 i = 0; i < ranges.GetSize();)
     {
-        rdata.AcquireBarriers.Append(
-            createAcquireBarrier(*range.GraphicsBuffer, range.GraphicsOffset, range.RequiredMemory));
+        const RangePair &range = ranges[i];
+        VkDeviceSize size = range.RequiredMemory;
+        for (++i; i < ranges.GetSize(); ++i)
+        {
+            const RangePair &next = ranges[i];
+            if (next.GraphicsBuffer != range.GraphicsBuffer || next.GraphicsOffset != range.GraphicsOffset + size)
+                break;
+            size += next.RequiredMemory;
+        }
 
+        rdata.AcquireBarriers.Append(createAcquireBarrier(*range.GraphicsBuffer, range.GraphicsOffset, size));
         if (release)
-            release->Append(createReleaseBarrier(*range.GraphicsBuffer, range.GraphicsOffset, range.RequiredMemory));
+            release->Append(createReleaseBarrier(*range.GraphicsBuffer, range.GraphicsOffset, size));
     }
-    for (const BufferCopySlice &cmdSlice : instanceCopyCmds)
+
+    // the memory type picked for direct writes is not guaranteed to be host coherent, in which case the writes only
+    // reach the device once flushed. flushing coherent memory does nothing
+    if (s_DirectInstanceWrites)
     {
-        const TKit::Span<const VkBufferCopy2KHR> cpspan{copies.Instance.GetData() + cmdSlice.Offset, cmdSlice.Size};
-        cmdSlice.Graphics->CopyFromBuffer2(command, *cmdSlice.Transfer, cpspan);
+        for (InstanceArena &arena : rdata.Geometry.Arenas)
+            ONYX_CHECK_VKIT_RESULT(arena.Graphics.Buffer.Flush());
+        for (Arena &arena : rdata.TableArenas)
+            ONYX_CHECK_VKIT_RESULT(arena.Graphics.Buffer.Flush());
     }
-    if (!copies.Vertex.IsEmpty())
-        rdata.Geometry.VertexArena.Graphics.Buffer.CopyFromBuffer2(command, rdata.Geometry.VertexArena.Transfer.Buffer,
-                                                                   copies.Vertex);
 
-    if (!copies.Index.IsEmpty())
-        rdata.Geometry.IndexArena.Graphics.Buffer.CopyFromBuffer2(command, rdata.Geometry.IndexArena.Transfer.Buffer,
-                                                                  copies.Index);
+    // direct writes leave nothing to copy unless dynamic meshes were uploaded, and without copies there is no submit
+    if (ranges.IsEmpty())
+        return;
+
+    const auto copyBuffer = [command](VKit::DeviceBuffer &dst, VKit::DeviceBuffer &src,
+                                      TKit::StackArray<VkBufferCopy2KHR> &bcopies) {
+        const u32 count = mergeBufferCopies(bcopies.GetData(), bcopies.GetSize());
+        if (count != 0)
+            dst.CopyFromBuffer2(command, src, TKit::Span<const VkBufferCopy2KHR>{bcopies.GetData(), count});
+    };
+
+    for (u32 geo = 0; geo < Geometry_Count; ++geo)
+    {
+        InstanceArena &arena = rdata.Geometry.Arenas[geo];
+        copyBuffer(arena.Graphics.Buffer, arena.Transfer.Buffer, copies.Instance[geo]);
+    }
+    copyBuffer(rdata.Geometry.VertexArena.Graphics.Buffer, rdata.Geometry.VertexArena.Transfer.Buffer, copies.Vertex);
+    copyBuffer(rdata.Geometry.IndexArena.Graphics.Buffer, rdata.Geometry.IndexArena.Transfer.Buffer, copies.Index);
+    for (u32 i = 0; i < ContextTable_Count; ++i)
+        copyBuffer(rdata.TableArenas[i].Graphics.Buffer, rdata.TableArenas[i].Transfer.Buffer, copies.Tables[i]);
 
     info.Command = command;
 }
@@ -2395,6 +2925,20 @@ template <Dimension D> void prepareRender()
         // TKIT_ASSERT(grange.ActiveIndexRange,
         //             "[ONYX][RENDERING] Graphics instance range failed to find an index graphics range");
     }
+
+    for (ContextInfo<D> &cinfo : rdata.Contexts)
+        for (u32 i = 0; i < ContextTable_Count; ++i)
+        {
+            ContextTableRange &tinfo = cinfo.Tables[i];
+            tinfo.Range = nullptr;
+            if (tinfo.Generation != 0)
+                for (GraphicsRange &tgrange : rdata.TableArenas[i].Graphics.Ranges)
+                    if (tgrange.Generation == tinfo.Generation)
+                    {
+                        tinfo.Range = &tgrange;
+                        break;
+                    }
+        }
 }
 
 void PrepareRender()
@@ -2459,12 +3003,40 @@ static VKit::DeviceBuffer *findAvailableIndexedDrawBuffer(const u32 drawCount, c
                                                                  inFlightValue);
 }
 
-template <Dimension D> static void bindMeshBuffers(const ResourcePool pool, const VkCommandBuffer command)
+enum IndexWidth : u8
+{
+    IndexWidth_Full,
+    IndexWidth_Short,
+    IndexWidth_Count,
+};
+
+template <Dimension D> static IndexWidth getIndexWidth(const Resource mesh)
+{
+    return Resources::HasShortIndices<D>(mesh) ? IndexWidth_Short : IndexWidth_Full;
+}
+
+template <Dimension D>
+static void bindMeshBuffers(const ResourcePool pool, const IndexWidth width, const VkCommandBuffer command)
 {
     const Resources::MeshBuffers buffers = Resources::GetMeshBuffers<D>(pool);
 
     buffers.VertexBuffer->BindAsVertexBuffer(command);
-    buffers.IndexBuffer->BindAsIndexBuffer<Index>(command);
+    if (width == IndexWidth_Short)
+        buffers.ShortIndexBuffer->BindAsIndexBuffer<u16>(command);
+    else
+        buffers.IndexBuffer->BindAsIndexBuffer<Index>(command);
+}
+
+static bool usesUnifiedMeshBuffers(const ResourceType rtype)
+{
+    return rtype != Resource_GlyphMesh && Resources::HasUnifiedMeshBuffers();
+}
+
+// with unified mesh buffers, the commands of all pools of a mesh type are gathered in the first slot, so that they are
+// drawn with a single bind and a single indirect call per cull mode
+static u32 getMeshCommandSlot(const ResourceType rtype, const Resource mesh)
+{
+    return usesUnifiedMeshBuffers(rtype) ? 0 : GetResourcePoolId(mesh);
 }
 
 static VkDrawIndirectCommand createCircleCommand(const u32 firstInstance, const u32 instanceCount)
@@ -2536,7 +3108,8 @@ template <Dimension D> static void endShadowTransitionLayout(const VkCommandBuff
 }
 
 template <Dimension D>
-static void beginShadowPass(const VkCommandBuffer cmd, TextureMap &map, const u32 imageViewIndex = 0)
+static void beginShadowPass(const VkCommandBuffer cmd, TextureMap &map, const u32 imageViewIndex = 0,
+                            const u32 viewMask = 0)
 {
     const VkImageLayout attLayout =
         D == D3 ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL_KHR : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
@@ -2556,6 +3129,7 @@ static void beginShadowPass(const VkCommandBuffer cmd, TextureMap &map, const u3
     renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
     renderInfo.renderArea = {{0, 0}, extent};
     renderInfo.layerCount = 1;
+    renderInfo.viewMask = viewMask;
     if constexpr (D == D3)
     {
         att.clearValue.depthStencil = {1.f, 0};
@@ -2612,7 +3186,7 @@ static void addTransferTrackerIfNeeded(TKit::StackArray<Execution::Tracker> &tra
 }
 
 template <Dimension D, typename F>
-static void collectDrawInfo(const VKit::Queue *graphics, const Geometry geo, const ViewMask viewBit,
+static void collectDrawInfo(const VKit::Queue *graphics, const Geometry geo, const ViewMask &viewBit,
                             const u64 inFlightValue, const F &insertCommand, const RenderModeFlags flags,
                             TKit::StackArray<Execution::Tracker> *transferTrackers = nullptr,
                             const BlendPass bpass = BlendPass_All)
@@ -2641,7 +3215,16 @@ static void collectDrawInfo(const VKit::Queue *graphics, const Geometry geo, con
         for (const ContextInstanceRange &crange : grange.ContextRanges)
         {
             if (rdata.IsContextRangeClean(viewBit, crange))
+            {
                 size += crange.Size;
+                for (const ContextTableRange &tinfo : rdata.Contexts[crange.ContextIndex].Tables)
+                    if (tinfo.Range)
+                    {
+                        tinfo.Range->GraphicsTracker.MarkInUse(graphics, inFlightValue);
+                        if (transferTrackers && tinfo.Range->InUseByTransfer())
+                            addTransferTrackerIfNeeded(*transferTrackers, tinfo.Range->TransferTracker);
+                    }
+            }
             else if (size != 0)
             {
                 const u32 fi = u32(offset / instanceSize);
@@ -2686,15 +3269,40 @@ static void collectDrawInfo(const VKit::Queue *graphics, const Geometry geo, con
     }
 }
 
+// depth state that geometry pipelines leave dynamic because it depends on per view settings
+using DepthFlags = u8;
+enum DepthFlagBit : DepthFlags
+{
+    DepthFlag_Test = 1U << 0,
+    DepthFlag_Write = 1U << 1,
+    DepthFlag_Reversed = 1U << 2,
+    DepthFlag_Prepassed = 1U << 3,
+};
+
 template <Dimension D>
 static void setupState(const VkCommandBuffer cmd, const RenderPass rpass, const Geometry geo,
-                       const VKit::PipelineLayout &playout, const VKit::GraphicsPipeline &pipeline)
+                       const VKit::PipelineLayout &playout, const VKit::GraphicsPipeline &pipeline,
+                       const DepthFlags dflags)
 {
     const RendererData<D> &rdata = getRendererData<D>();
     const VkDescriptorSet set = rdata.Descriptors[rpass][geo];
 
     pipeline.Bind(cmd);
     VKit::DescriptorSet::Bind(GetDevice(), cmd, set, VK_PIPELINE_BIND_POINT_GRAPHICS, playout);
+
+    const auto table = GetDeviceTable();
+    const bool prepassed = dflags & DepthFlag_Prepassed;
+    if (dflags & DepthFlag_Test)
+    {
+        VkCompareOp op;
+        if (dflags & DepthFlag_Reversed)
+            op = prepassed ? VK_COMPARE_OP_GREATER_OR_EQUAL : VK_COMPARE_OP_GREATER;
+        else
+            op = prepassed ? VK_COMPARE_OP_LESS_OR_EQUAL : VK_COMPARE_OP_LESS;
+        table->CmdSetDepthCompareOpEXT(cmd, op);
+    }
+    if (dflags & DepthFlag_Write)
+        table->CmdSetDepthWriteEnableEXT(cmd, prepassed ? VK_FALSE : VK_TRUE);
 }
 
 enum CullMode : u8
@@ -2710,32 +3318,54 @@ using CircleDrawCommands = TKit::TierArray<VkDrawIndirectCommand>;
 
 using IndexedCommands = TKit::TierArray<VkDrawIndexedIndirectCommand>;
 
-// per mesh type per resource pool per cull mode per draw cmd
+// per mesh type per resource pool per index width per cull mode per draw cmd
 using PerCullPerCmd = ten<IndexedCommands, CullMode_Count>;
-using MeshDrawCommands = ten<IndexedCommands, Resource_MeshPoolCount, ONYX_MAX_RESOURCE_POOLS, CullMode_Count>;
+using MeshDrawCommands =
+    ten<IndexedCommands, Resource_MeshPoolCount, ONYX_MAX_RESOURCE_POOLS, IndexWidth_Count, CullMode_Count>;
 
 // per cull mode per draw cmd
 using DynMeshDrawCommands = ten<IndexedCommands, CullMode_Count>;
 
+// draw commands of a single blend pass. views that see the exact same contexts share one of these, so that the
+// instance ranges are only walked once for all of them. the indirect buffers are written the first time the list is
+// submitted and reused by the rest of the views
+struct DrawList
+{
+    TKit::FixedArray<CircleDrawCommands, PipelinePass_Count> CircleCmds{};
+    TKit::FixedArray<DynMeshDrawCommands, PipelinePass_Count> DynMeshCmds{};
+    TKit::FixedArray<MeshDrawCommands, PipelinePass_Count> MeshCmds{};
+    TKit::FixedArray<u32, PipelinePass_Count> CmdCount{0, 0, 0};
+
+    TKit::FixedArray<VKit::DeviceBuffer *, PipelinePass_Count> CircleBuffers{};
+    TKit::FixedArray<VKit::DeviceBuffer *, PipelinePass_Count> DynMeshBuffers{};
+    ten<VKit::DeviceBuffer *, PipelinePass_Count, Resource_MeshPoolCount, ONYX_MAX_RESOURCE_POOLS, IndexWidth_Count>
+        MeshBuffers{};
+
+    u32 AmbientColor = 0;
+};
+
 TKIT_COMPILER_WARNING_IGNORE_PUSH()
 TKIT_MSVC_WARNING_IGNORE(4127)
 template <Dimension D>
 static void submitDrawCommands(const VKit::Queue *graphics, const u64 inFlightValue, const VkCommandBuffer cmd,
                                const RenderPass rpass, const VKit::PipelineLayout &playout,
-                               const ten<VKit::GraphicsPipeline, Geometry_Count> &pipelines,
-                               const CircleDrawCommands &circleCmds, const MeshDrawCommands &meshCmds,
-                               const DynMeshDrawCommands &dynMeshCmds)
+                               const ten<VKit::GraphicsPipeline, Geometry_Count> &pipelines, DrawList &list,
+                               const PipelinePass pass, const DepthFlags dflags)
 {
     const auto table = GetDeviceTable();
+    const CircleDrawCommands &circleCmds = list.CircleCmds[pass];
     const u32 drawCount = circleCmds.GetSize();
     const usz size = circleCmds.GetBytes();
     if (drawCount != 0)
     {
-        setupState<D>(cmd, rpass, Geometry_Circle, playout, pipelines[Geometry_Circle]);
-        VKit::DeviceBuffer *dbuffer = findAvailableDrawBuffer(drawCount, graphics, inFlightValue);
-
-        dbuffer->Write(circleCmds.GetData(), {.srcOffset = 0, .dstOffset = 0, .size = size});
-        ONYX_CHECK_VKIT_RESULT(dbuffer->Flush());
+        setupState<D>(cmd, rpass, Geometry_Circle, playout, pipelines[Geometry_Circle], dflags);
+        VKit::DeviceBuffer *&dbuffer = list.CircleBuffers[pass];
+        if (!dbuffer)
+        {
+            dbuffer = findAvailableDrawBuffer(drawCount, graphics, inFlightValue);
+            dbuffer->Write(circleCmds.GetData(), {.srcOffset = 0, .dstOffset = 0, .size = size});
+            ONYX_CHECK_VKIT_RESULT(dbuffer->Flush());
+        }
         table->CmdDrawIndirect(cmd, *dbuffer, 0, drawCount, sizeof(VkDrawIndirectCommand));
     }
 
@@ -2745,7 +3375,8 @@ static void submitDrawCommands(const VKit::Queue *graphics, const u64 inFlightVa
         return !drawCmds[CullMode_None].IsEmpty() || !drawCmds[CullMode_Back].IsEmpty();
     };
 
-    const auto drawCulledMeshes = [&]([[maybe_unused]] const Geometry geo, const PerCullPerCmd &drawCmds) {
+    const auto drawCulledMeshes = [&]([[maybe_unused]] const Geometry geo, const PerCullPerCmd &drawCmds,
+                                      VKit::DeviceBuffer *&dbuffer) {
         const TKit::TierArray<VkDrawIndexedIndirectCommand> &cmds1 = drawCmds[CullMode_None];
         const TKit::TierArray<VkDrawIndexedIndirectCommand> &cmds2 = drawCmds[CullMode_Back];
 
@@ -2759,15 +3390,18 @@ static void submitDrawCommands(const VKit::Queue *graphics, const u64 inFlightVa
         TKIT_ASSERT((D == D3 && geo != Geometry_Glyph) || size2 == 0,
                     "[ONYX][RENDERER] No back culling draw commands must be submitted for flat geometry");
 
-        VKit::DeviceBuffer *dbuffer = findAvailableIndexedDrawBuffer(drawCount, graphics, inFlightValue);
+        if (!dbuffer)
+        {
+            dbuffer = findAvailableIndexedDrawBuffer(drawCount, graphics, inFlightValue);
 
-        if (D == D2 || size1 != 0)
-            dbuffer->Write(cmds1.GetData(), {.srcOffset = 0, .dstOffset = 0, .size = size1});
-        if constexpr (D == D3)
-            if (size2 != 0)
-                dbuffer->Write(cmds2.GetData(), {.srcOffset = 0, .dstOffset = size1, .size = size2});
+            if (D == D2 || size1 != 0)
+                dbuffer->Write(cmds1.GetData(), {.srcOffset = 0, .dstOffset = 0, .size = size1});
+            if constexpr (D == D3)
+                if (size2 != 0)
+                    dbuffer->Write(cmds2.GetData(), {.srcOffset = 0, .dstOffset = size1, .size = size2});
 
-        ONYX_CHECK_VKIT_RESULT(dbuffer->Flush());
+            ONYX_CHECK_VKIT_RESULT(dbuffer->Flush());
+        }
 
         if constexpr (D == D3)
             if (geo != Geometry_Glyph)
@@ -2784,31 +3418,49 @@ static void submitDrawCommands(const VKit::Queue *graphics, const u64 inFlightVa
     };
 
     const auto renderMeshGeometry = [&](const Geometry geo) {
-        setupState<D>(cmd, rpass, geo, playout, pipelines[geo]);
+        setupState<D>(cmd, rpass, geo, playout, pipelines[geo], dflags);
 
         const ResourceType rtype = getResourceType(geo);
         const TKit::Span<const u32> poolIds = Resources::GetResourcePoolIds<D>(rtype);
 
-        for (const ResourcePool pid : poolIds)
-            if (hasCommands(meshCmds[rtype][pid]))
+        // each pool is drawn once per index width it holds commands for, rebinding only the index buffer in between
+        const auto drawPool = [&](const ResourcePool pool, const u32 slot) {
+            for (u32 i = 0; i < IndexWidth_Count; ++i)
             {
-                bindMeshBuffers<D>(CreateResourcePoolHandle(rtype, pid), cmd);
-                drawCulledMeshes(geo, meshCmds[rtype][pid]);
+                const IndexWidth width = IndexWidth(i);
+                if (hasCommands(list.MeshCmds[pass][rtype][slot][width]))
+                {
+                    bindMeshBuffers<D>(pool, width, cmd);
+                    drawCulledMeshes(geo, list.MeshCmds[pass][rtype][slot][width],
+                                     list.MeshBuffers[pass][rtype][slot][width]);
+                }
             }
+        };
+
+        // any pool handle binds the unified buffers
+        if (usesUnifiedMeshBuffers(rtype))
+        {
+            if (poolIds.GetSize() != 0)
+                drawPool(CreateResourcePoolHandle(rtype, poolIds[0]), 0);
+            return;
+        }
+
+        for (const ResourcePool pid : poolIds)
+            drawPool(CreateResourcePoolHandle(rtype, pid), pid);
     };
 
     renderMeshGeometry(Geometry_Static);
     renderMeshGeometry(Geometry_Parametric);
     renderMeshGeometry(Geometry_Glyph);
 
-    if (hasCommands(dynMeshCmds))
+    if (hasCommands(list.DynMeshCmds[pass]))
     {
         RendererData<D> &rdata = getRendererData<D>();
-        setupState<D>(cmd, rpass, Geometry_Dynamic, playout, pipelines[Geometry_Dynamic]);
+        setupState<D>(cmd, rpass, Geometry_Dynamic, playout, pipelines[Geometry_Dynamic], dflags);
         rdata.Geometry.VertexArena.Graphics.Buffer.BindAsVertexBuffer(cmd);
         rdata.Geometry.IndexArena.Graphics.Buffer.template BindAsIndexBuffer<Index>(cmd);
 
-        drawCulledMeshes(Geometry_Dynamic, dynMeshCmds);
+        drawCulledMeshes(Geometry_Dynamic, list.DynMeshCmds[pass], list.DynMeshBuffers[pass]);
     }
 }
 TKIT_COMPILER_WARNING_IGNORE_POP()
@@ -2828,7 +3480,7 @@ static CullMode getCullMode(const Resource handle)
 }
 
 template <Dimension D>
-static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd, const ViewMask viewBit,
+static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd, const ViewMask &viewBit,
                           const u64 inFlightValue)
 {
     RendererData<D> &rdata = getRendererData<D>();
@@ -2864,7 +3516,7 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
 
                 const LightParams &params = lights[i];
 
-                const u32 viewIndex = std::popcount(data.ViewMask & (viewBit - 1));
+                const u32 viewIndex = data.ViewMask.GetCountBelow(viewBit.GetFirstIndex());
                 const u32 shindex = data.ShadowMapOffset + viewIndex;
                 const u32 shPoolIndex = computeShadowMapPoolIndex<D>(ltype, shindex);
 
@@ -2876,9 +3528,12 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
                 if (!(dirtyViews & viewBit))
                     continue;
 
-                CircleDrawCommands circleCmds{};
-                DynMeshDrawCommands dynMeshCmds{};
-                MeshDrawCommands meshCmds{};
+                // shadow passes only fill the flat slot of the list. its indirect buffers are written by the first map
+                // that submits it and reused by the rest, such as the remaining cascades
+                DrawList list{};
+                CircleDrawCommands &circleCmds = list.CircleCmds[PipelinePass_Flat];
+                DynMeshDrawCommands &dynMeshCmds = list.DynMeshCmds[PipelinePass_Flat];
+                MeshDrawCommands &meshCmds = list.MeshCmds[PipelinePass_Flat];
                 const auto insertCommand = [&](const ResourceType rtype, const GraphicsInstanceRange &grange,
                                                const u32 fi, const u32 ic) {
                     if (grange.MeshHandle == NullHandle) // circles sentry
@@ -2895,9 +3550,11 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
 #endif
                         ONYX_CHECK_RESOURCE_IS_VALID_WITH_DIM(grange.MeshHandle, rtype, D);
 
-                        const u32 pid = GetResourcePoolId(grange.MeshHandle);
-                        PerCullPerCmd &cmds = rtype == Resource_DynamicMesh ? dynMeshCmds : meshCmds[rtype][pid];
-                        const VkDrawIndexedIndirectCommand cmd = rtype == Resource_DynamicMesh
+                        const bool dynamic = rtype == Resource_DynamicMesh;
+                        const u32 slot = getMeshCommandSlot(rtype, grange.MeshHandle);
+                        PerCullPerCmd &cmds =
+                            dynamic ? dynMeshCmds : meshCmds[rtype][slot][getIndexWidth<D>(grange.MeshHandle)];
+                        const VkDrawIndexedIndirectCommand cmd = dynamic
                                                                      ? createDynamicMeshCommand<D>(grange, fi, ic)
                                                                      : createMeshCommand<D>(grange.MeshHandle, fi, ic);
 
@@ -2915,8 +3572,9 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
                     collectDrawInfo<D>(graphics, geo, viewBit, inFlightValue, insertCommand, RenderModeFlag_Shaded);
                 }
 
-                const auto processMap = [&](TextureMap &map, const f32m4 &projView, const u32 viewIndex = 0) {
-                    beginShadowPass<D>(cmd, map, viewIndex);
+                const auto processMap = [&](TextureMap &map, const f32m4 &projView, const u32 viewIndex = 0,
+                                            const u32 viewMask = 0) {
+                    beginShadowPass<D>(cmd, map, viewIndex, viewMask);
                     const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout<D>(RenderPass_Shadow);
 
                     ShadowPushConstantData<D> pdata;
@@ -2941,8 +3599,12 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
                     }
 
                     table->CmdPushConstants(cmd, playout, flags, 0, sizeof(ShadowPushConstantData<D>), &pdata);
-                    submitDrawCommands<D>(graphics, inFlightValue, cmd, RenderPass_Shadow, playout, sdata.Pipelines,
-                                          circleCmds, meshCmds, dynMeshCmds);
+                    if constexpr (D == D3 && isPoint)
+                        submitDrawCommands<D>(graphics, inFlightValue, cmd, RenderPass_Shadow, playout,
+                                              sdata.PointPipelines, list, PipelinePass_Flat, 0);
+                    else
+                        submitDrawCommands<D>(graphics, inFlightValue, cmd, RenderPass_Shadow, playout,
+                                              sdata.Pipelines, list, PipelinePass_Flat, 0);
 
                     endShadowPass(cmd);
                 };
@@ -3012,26 +3674,14 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
                 else
                 {
                     beginShadowTransitionLayout<D3>(cmd, smap);
-                    // TODO(Isma): Try to pseudo optimize this by working out the views?
                     if constexpr (isPoint)
                     {
+                        // each view of the multiview pass rotates positions into its cube face in the vertex shader,
+                        // so only the projection is pushed. the face orientations live in shader.slang
                         const f32 near = ONYX_POINT_LIGHT_NEAR_RADIUS_FACTOR * data.ShadowRadius;
                         const f32 far = data.ShadowRadius;
                         const f32m4 proj = Transform<D3>::Perspective(0.5f * Math::Pi(), near, far);
-
-                        constexpr f32v3 faceDir[6] = {
-                            f32v3{1.f, 0.f, 0.f},  f32v3{-1.f, 0.f, 0.f}, f32v3{0.f, 1.f, 0.f},
-                            f32v3{0.f, -1.f, 0.f}, f32v3{0.f, 0.f, 1.f},  f32v3{0.f, 0.f, -1.f},
-                        };
-                        constexpr f32v3 faceUp[6] = {
-                            f32v3{0.f, -1.f, 0.f}, f32v3{0.f, -1.f, 0.f}, f32v3{0.f, 0.f, 1.f},
-                            f32v3{0.f, 0.f, -1.f}, f32v3{0.f, -1.f, 0.f}, f32v3{0.f, -1.f, 0.f},
-                        };
-                        for (u32 j = 0; j < 6; ++j)
-                        {
-                            const f32m4 view = Transform<D3>::LookTowards(data.Position, faceDir[j], faceUp[j]);
-                            processMap(smap, proj * view, j);
-                        }
+                        processMap(smap, proj, 0, s_CubeFaceViewMask);
                     }
                     else if constexpr (isDir)
                     {
@@ -3054,12 +3704,10 @@ static void renderShadows(const VKit::Queue *graphics, const VkCommandBuffer cmd
 }
 
 template <Dimension D>
-static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cmd, const ViewInfo<D> &vinfo,
-                           const BlendPass bpass, const u64 inFlightValue,
-                           TKit::StackArray<Execution::Tracker> &transferTrackers, const bool shadows)
+static void collectDrawList(const VKit::Queue *graphics, const ViewMask &viewBit, const BlendPass bpass,
+                            const u64 inFlightValue, TKit::StackArray<Execution::Tracker> &transferTrackers,
+                            DrawList &list)
 {
-    const ViewMask viewBit = vinfo.ViewBit;
-
     RendererData<D> &rdata = getRendererData<D>();
 
     // TODO(Isma): At some point would be good letting the user decide what strategy to use to aggregate ambient
@@ -3070,12 +3718,12 @@ static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cm
             const Color &a = info.Context->GetAmbientLight();
             ambient.rgba = Math::Max(ambient.rgba, a.rgba);
         }
-    const u32 ambientColor = ambient.ToLinear().Pack();
+    list.AmbientColor = ambient.ToLinear().Pack();
 
-    TKit::FixedArray<CircleDrawCommands, PipelinePass_Count> circleCmds{};
-    TKit::FixedArray<DynMeshDrawCommands, PipelinePass_Count> dynMeshCmds{};
-    TKit::FixedArray<MeshDrawCommands, PipelinePass_Count> meshCmds{};
-    TKit::FixedArray<u32, PipelinePass_Count> cmdCount{0, 0, 0};
+    TKit::FixedArray<CircleDrawCommands, PipelinePass_Count> &circleCmds = list.CircleCmds;
+    TKit::FixedArray<DynMeshDrawCommands, PipelinePass_Count> &dynMeshCmds = list.DynMeshCmds;
+    TKit::FixedArray<MeshDrawCommands, PipelinePass_Count> &meshCmds = list.MeshCmds;
+    TKit::FixedArray<u32, PipelinePass_Count> &cmdCount = list.CmdCount;
 
     const auto insertCommand = [&](const ResourceType rtype, const GraphicsInstanceRange &grange, const u32 fi,
                                    const u32 ic) {
@@ -3109,7 +3757,7 @@ static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cm
 #endif
             ONYX_CHECK_RESOURCE_IS_VALID_WITH_DIM(grange.MeshHandle, rtype, D);
 
-            const u32 pid = GetResourcePoolId(grange.MeshHandle);
+            const u32 slot = getMeshCommandSlot(rtype, grange.MeshHandle);
 
             CullMode cull;
             if constexpr (D == D2)
@@ -3128,12 +3776,15 @@ static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cm
                     ++cmdCount[p];
                 }
             else
+            {
+                const IndexWidth width = getIndexWidth<D>(grange.MeshHandle);
                 for (u32 i = 0; i < pcount; ++i)
                 {
                     const PipelinePass p = passes[i];
-                    meshCmds[p][rtype][pid][cull].Append(cmd);
+                    meshCmds[p][rtype][slot][width][cull].Append(cmd);
                     ++cmdCount[p];
                 }
+            }
         }
     };
 
@@ -3160,25 +3811,46 @@ static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cm
         if (arena.ActiveRange->InUseByTransfer())
             addTransferTrackerIfNeeded(transferTrackers, arena.ActiveRange->TransferTracker);
     }
+}
+
+template <Dimension D>
+static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cmd, const ViewInfo<D> &vinfo,
+                           DrawList &list, const BlendPass bpass, const SampleCount samples, const u64 inFlightValue,
+                           const bool shadows, const bool depthPrepass)
+{
+    const RendererData<D> &rdata = getRendererData<D>();
+    const LightData<D> &ldata = rdata.Lights;
+    const ShadowData<D> &sdata = rdata.Shadows;
 
     const auto table = GetDeviceTable();
+    const auto &pipelines = getGeometryPipelines<D>(samples);
+
+    ShadedFlags features = ShadedFlag_Shadows * shadows;
+    if constexpr (D == D3)
+        features |= ShadedFlag_TiledLighting * vinfo.TiledLighting;
 
-    ShadowData<D> &sdata = rdata.Shadows;
     for (u32 i = 0; i < PipelinePass_Count; ++i)
     {
-        if (cmdCount[i] == 0)
+        if (list.CmdCount[i] == 0)
             continue;
         const PipelinePass pass = PipelinePass(i);
         const RenderPass rpass = GetRenderPass(pass);
         const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout<D>(rpass);
         if (rpass == RenderPass_Flat)
-            table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(FlatPushConstantData),
-                                    &vinfo.ProjectionView);
+        {
+            FlatPushConstantData pdata;
+            pdata.ProjectionView = vinfo.ProjectionView;
+            pdata.Flags = FlatFlag_ReversedDepth * vinfo.ReversedDepth;
+            table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                    sizeof(FlatPushConstantData), &pdata);
+        }
         else
         {
             ShadedPushConstantData<D> pdata;
             pdata.ProjectionView = vinfo.ProjectionView;
-            pdata.Flags = ShadedFlag_Shadows * shadows;
+            pdata.Flags = features | (ShadedFlag_ReversedDepth * vinfo.ReversedDepth);
+            if constexpr (D == D3)
+                pdata.Flags |= vinfo.AttachmentIndex << ONYX_SHADED_FLAGS_ATTACHMENT_SHIFT;
 
             for (u32 j = 0; j < LightTypeCount<D>; ++j)
             {
@@ -3192,21 +3864,132 @@ static void renderGeometry(const VKit::Queue *graphics, const VkCommandBuffer cm
                 pdata.ViewForward = vinfo.ViewForward;
             }
 
-            pdata.ViewBit = viewBit;
-            pdata.AmbientColor = ambientColor;
+            pdata.ViewIndex = vinfo.ViewBit.GetFirstIndex();
+            pdata.AmbientColor = list.AmbientColor;
             table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
                                     sizeof(ShadedPushConstantData<D>), &pdata);
+
+            // the light tile set is statically used by the shaded fragment shaders, so it must always be bound. it
+            // is left untouched by the per geometry binds of set 0
+            if constexpr (D == D3)
+            {
+                const VkDescriptorSet set = vinfo.LightTileSet;
+                table->CmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, playout, ONYX_LIGHT_TILES_SET, 1,
+                                             &set, 0, nullptr);
+            }
+        }
+
+        DepthFlags dflags = 0;
+        if (pass != PipelinePass_Outlined)
+            dflags |= DepthFlag_Test;
+        if (vinfo.ReversedDepth)
+            dflags |= DepthFlag_Reversed;
+
+        const bool opaqueShaded = pass == PipelinePass_Shaded && bpass != BlendPass_Transparent;
+        if (opaqueShaded)
+        {
+            // the prepass reuses the same indirect commands and push constants, so that the expensive shaded fragments
+            // that follow only run for the visible surface
+            if (depthPrepass)
+            {
+                submitDrawCommands<D>(graphics, inFlightValue, cmd, rpass, playout,
+                                      getDepthPrepassPipelines<D>(samples), list, pass, dflags);
+                dflags |= DepthFlag_Prepassed;
+            }
+            dflags |= DepthFlag_Write;
         }
 
         const u32 idx = bpass == BlendPass_All ? BlendPass_Opaque : bpass;
-        submitDrawCommands<D>(graphics, inFlightValue, cmd, rpass, playout, rdata.Geometry.Pipelines[idx][pass],
-                              circleCmds[pass], meshCmds[pass], dynMeshCmds[pass]);
+        if (pass == PipelinePass_Shaded)
+            submitDrawCommands<D>(graphics, inFlightValue, cmd, rpass, playout,
+                                  getShadedPipelines<D>(samples, features)[idx], list, pass, dflags);
+        else
+            submitDrawCommands<D>(graphics, inFlightValue, cmd, rpass, playout, pipelines[idx][pass], list, pass,
+                                  dflags);
     }
 }
 
+// builds the per tile light lists of the view. it must run outside of any render pass, right before the opaque pass
+static void cullLights(const VkCommandBuffer cmd, RenderView<D3> *rv, const ViewInfo<D3> &vinfo)
+{
+    const RendererData<D3> &rdata = getRendererData<D3>();
+    const LightData<D3> &ldata = rdata.Lights;
+
+    const auto table = GetDeviceTable();
+    const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout(StandalonePass_LightCull);
+
+    s_LightCullPipeline.Bind(cmd);
+    const TKit::FixedArray<VkDescriptorSet, 2> sets{rdata.Descriptors[RenderPass_Shaded][0], vinfo.LightTileSet};
+    table->CmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, playout, 0, sets.GetSize(), sets.GetData(), 0,
+                                 nullptr);
+
+    const u32v2 tiles = rv->GetLightTileCount();
+
+    LightCullPushConstantData pdata;
+    pdata.ProjectionView = vinfo.ProjectionView;
+    pdata.Extent = rv->GetScaledRenderExtent();
+    pdata.PointRange = (ldata.Ranges[Light_Point].Offset << 16) | ldata.Ranges[Light_Point].Count;
+    pdata.SpotRange = (ldata.Ranges[Light_Spot].Offset << 16) | ldata.Ranges[Light_Spot].Count;
+    pdata.TileCountX = tiles[0];
+    pdata.AttachmentIndex = vinfo.AttachmentIndex;
+    pdata.ViewIndex = vinfo.ViewBit.GetFirstIndex();
+    TKIT_ASSERT(pdata.AttachmentIndex < ONYX_MAX_ATTACHMENTS,
+                "[ONYX][RENDERER] The maximum amount of attachments has been exceeded ({} >= {})",
+                pdata.AttachmentIndex, ONYX_MAX_ATTACHMENTS);
+
+    table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(LightCullPushConstantData), &pdata);
+    table->CmdDispatch(cmd, tiles[0], tiles[1], 1);
+
+    VkBufferMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+    barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
+    barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT_KHR;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = rv->GetLightTiles().GetHandle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    info.bufferMemoryBarrierCount = 1;
+    info.pBufferMemoryBarriers = &barrier;
+    table->CmdPipelineBarrier2KHR(cmd, &info);
+}
+
+// finds the depth range of the surfaces the view rendered, which is read back a few frames later to fit the cascades of
+// directional lights. it must run once the depth attachment has been transitioned to be read by compute shaders
+static void reduceDepth(const VkCommandBuffer cmd, RenderView<D3> *rv)
+{
+    const auto table = GetDeviceTable();
+    const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout(StandalonePass_DepthReduce);
+
+    s_DepthReducePipeline.Bind(cmd);
+    const VkDescriptorSet set = rv->GetDepthReduceSet();
+    VKit::DescriptorSet::Bind(GetDevice(), cmd, set, VK_PIPELINE_BIND_POINT_COMPUTE, playout);
+
+    DepthReducePushConstantData pdata;
+    pdata.Extent = rv->GetScaledRenderExtent();
+    pdata.AttachmentIndex = rv->GetAttachmentIndex();
+    pdata.ReversedDepth = rv->HasReversedDepth();
+    TKIT_ASSERT(pdata.AttachmentIndex < ONYX_MAX_ATTACHMENTS,
+                "[ONYX][RENDERER] The maximum amount of attachments has been exceeded ({} >= {})",
+                pdata.AttachmentIndex, ONYX_MAX_ATTACHMENTS);
+
+    table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(DepthReducePushConstantData),
+                            &pdata);
+
+    const u32v2 groups = (pdata.Extent + ONYX_DEPTH_REDUCE_GROUP_SIZE - 1U) / ONYX_DEPTH_REDUCE_GROUP_SIZE;
+    table->CmdDispatch(cmd, groups[0], groups[1], 1);
+    rv->EndDepthReduction(cmd);
+}
+
 static RenderSubmitInfo createRenderSubmitInfo(VKit::Queue *graphics, const VkCommandBuffer command,
                                                const u64 graphicsFlight, const RenderTargetInfo &tinfo,
-                                               TKit::StackArray<Execution::Tracker> &transferTrackers)
+                                               TKit::StackArray<Execution::Tracker> &transferTrackers,
+                                               const bool directCopy)
 {
     RenderSubmitInfo submitInfo{};
     submitInfo.Command = command;
@@ -3219,7 +4002,9 @@ static RenderSubmitInfo createRenderSubmitInfo(VKit::Queue *graphics, const VkCo
         imgInfo.pNext = nullptr;
         imgInfo.semaphore = tinfo.ImageAvailableSemaphore;
         imgInfo.deviceIndex = 0;
-        imgInfo.stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
+        imgInfo.stageMask = directCopy ? (VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR |
+                                          VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR)
+                                       : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
     }
 
     VkSemaphoreSubmitInfoKHR &gtimSemInfo = submitInfo.SignalSemaphores.Append();
@@ -3249,11 +4034,27 @@ static RenderSubmitInfo createRenderSubmitInfo(VKit::Queue *graphics, const VkCo
         ttimSemInfo.semaphore = ttracker.Queue->GetTimelineSempahore();
         ttimSemInfo.deviceIndex = 0;
         ttimSemInfo.value = ttracker.InFlightValue;
-        ttimSemInfo.stageMask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR;
+        ttimSemInfo.stageMask = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
     }
     return submitInfo;
 }
 
+// whether the two views see the exact same contexts, in which case they will also collect the exact same draw
+// commands and can share them
+template <Dimension D> static bool haveSameContexts(const ViewMask &viewBit1, const ViewMask &viewBit2)
+{
+    const RendererData<D> &rdata = getRendererData<D>();
+    for (const ContextInfo<D> &info : rdata.Contexts)
+    {
+        const ViewMask &transferred = info.Views;
+        const ViewMask &current = info.Context->GetViewMask();
+        if (bool(transferred & viewBit1) != bool(transferred & viewBit2) ||
+            bool(current & viewBit1) != bool(current & viewBit2))
+            return false;
+    }
+    return true;
+}
+
 template <Dimension D>
 static void renderViews(const TKit::TierArray<RenderView<D> *> &views, VKit::Queue *graphics, const VkCommandBuffer cmd,
                         const u64 graphicsFlight, TKit::StackArray<Execution::Tracker> &transferTrackers)
@@ -3268,33 +4069,84 @@ static void renderViews(const TKit::TierArray<RenderView<D> *> &views, VKit::Que
     TKit::StackArray<RenderView<D> *> ppViews{};
     ppViews.Reserve(views.GetSize());
 
+    TKit::StackArray<RenderView<D> *> visible{};
+    visible.Reserve(views.GetSize());
     for (RenderView<D> *rv : views)
+        if (!(rv->GetFlags() & RenderViewFlag_Hidden))
+            visible.Append(rv);
+
+    TKit::StackArray<RenderView<D> *> group{};
+    group.Reserve(visible.GetSize());
+
+    for (u32 i = 0; i < visible.GetSize(); ++i)
     {
-        const RenderViewFlags flags = rv->GetFlags();
-        if (flags & RenderViewFlag_Hidden)
+        RenderView<D> *leader = visible[i];
+        if (!leader)
             continue;
-        if (flags & RenderViewFlag_PostProcess)
-            ppViews.Append(rv);
-
-        const bool shadows = flags & RenderViewFlag_Shadows;
-        if (shadows)
-            renderShadows<D>(graphics, cmd, rv->GetViewBit(), graphicsFlight);
 
-        rv->CacheMatrices();
-        const ViewInfo<D> vinfo = rv->CreateViewInfo();
+        const ViewMask leaderBit = leader->GetViewBit();
+        const bool transparency = leader->GetFlags() & RenderViewFlag_Transparency;
 
-        rv->MarkCurrentAttachmentsInUse(tracker);
+        // grouped views are nulled out so that they are not visited again as leaders
+        group.Clear();
+        group.Append(leader);
+        for (u32 j = i + 1; j < visible.GetSize(); ++j)
+        {
+            RenderView<D> *rv = visible[j];
+            if (rv && bool(rv->GetFlags() & RenderViewFlag_Transparency) == transparency &&
+                haveSameContexts<D>(leaderBit, rv->GetViewBit()))
+            {
+                group.Append(rv);
+                visible[j] = nullptr;
+            }
+        }
 
-        const bool transparency = flags & RenderViewFlag_Transparency;
         const BlendPass opaquePass = transparency ? BlendPass_Opaque : BlendPass_All;
+        {
+            DrawList list{};
+            collectDrawList<D>(graphics, leaderBit, opaquePass, graphicsFlight, transferTrackers, list);
+            for (RenderView<D> *rv : group)
+            {
+                const RenderViewFlags flags = rv->GetFlags();
+                if (flags & RenderViewFlag_PostProcess)
+                    ppViews.Append(rv);
+
+                const bool shadows = flags & RenderViewFlag_Shadows;
+                if (shadows)
+                    renderShadows<D>(graphics, cmd, rv->GetViewBit(), graphicsFlight);
+
+                rv->CacheMatrices();
+                const ViewInfo<D> vinfo = rv->CreateViewInfo();
+
+                rv->MarkCurrentAttachmentsInUse(tracker);
+
+                if constexpr (D == D3)
+                    if (vinfo.TiledLighting)
+                        cullLights(cmd, rv, vinfo);
+
+                rv->BeginOpaquePass(cmd);
+                renderGeometry<D>(graphics, cmd, vinfo, list, opaquePass, rv->GetSampleCount(), graphicsFlight,
+                                  shadows, flags & RenderViewFlag_DepthPrepass);
+                rv->EndOpaquePass(cmd);
 
-        rv->BeginOpaquePass(cmd);
-        renderGeometry<D>(graphics, cmd, vinfo, opaquePass, graphicsFlight, transferTrackers, shadows);
-        rv->EndOpaquePass(cmd);
-        if (transparency)
+                if constexpr (D == D3)
+                    if (!transparency && (flags & RenderViewFlag_SampleDistributedShadows))
+                        reduceDepth(cmd, rv);
+            }
+        }
+        if (!transparency)
+            continue;
+
+        DrawList list{};
+        collectDrawList<D>(graphics, leaderBit, BlendPass_Transparent, graphicsFlight, transferTrackers, list);
+        for (RenderView<D> *rv : group)
         {
+            const bool shadows = rv->GetFlags() & RenderViewFlag_Shadows;
+            const ViewInfo<D> vinfo = rv->CreateViewInfo();
+
             rv->BeginTransparentPass(cmd);
-            renderGeometry<D>(graphics, cmd, vinfo, BlendPass_Transparent, graphicsFlight, transferTrackers, shadows);
+            renderGeometry<D>(graphics, cmd, vinfo, list, BlendPass_Transparent, rv->GetSampleCount(),
+                              graphicsFlight, shadows, false);
             rv->EndTransparentPass(cmd);
             rv->BeginBlendPass(cmd);
             s_BlendPipeline.Bind(cmd);
@@ -3303,15 +4155,21 @@ static void renderViews(const TKit::TierArray<RenderView<D> *> &views, VKit::Que
             const VkDescriptorSet set = rv->GetBlendSet();
             VKit::DescriptorSet::Bind(device, cmd, set, VK_PIPELINE_BIND_POINT_GRAPHICS, playout);
 
-            const u32 idx = rv->GetAttachmentIndex();
-            TKIT_ASSERT(idx < ONYX_MAX_ATTACHMENTS,
-                        "[ONYX][RENDERER] The maximum amount of attachments has been exceeded ({} >= {})", idx,
-                        ONYX_MAX_ATTACHMENTS);
+            BlendPushConstantData pdata;
+            pdata.AttachmentIndex = rv->GetAttachmentIndex();
+            pdata.UvScale = rv->GetResolutionUvScale();
+            TKIT_ASSERT(pdata.AttachmentIndex < ONYX_MAX_ATTACHMENTS,
+                        "[ONYX][RENDERER] The maximum amount of attachments has been exceeded ({} >= {})",
+                        pdata.AttachmentIndex, ONYX_MAX_ATTACHMENTS);
 
-            table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(BlendPushConstantData), &idx);
+            table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(BlendPushConstantData),
+                                    &pdata);
             table->CmdDraw(cmd, 6, 1, 0, 0);
 
             rv->EndBlendPass(cmd);
+            if constexpr (D == D3)
+                if (rv->GetFlags() & RenderViewFlag_SampleDistributedShadows)
+                    reduceDepth(cmd, rv);
         }
     }
 
@@ -3333,7 +4191,8 @@ static void renderViews(const TKit::TierArray<RenderView<D> *> &views, VKit::Que
                         "[ONYX][RENDERER] The maximum amount of attachments has been exceeded ({} >= {})",
                         pdata.AttachmentIndex, ONYX_MAX_ATTACHMENTS);
 
-            pdata.Extent = rv->GetRenderExtent();
+            pdata.Extent = rv->GetScaledRenderExtent();
+            pdata.UvScale = rv->GetResolutionUvScale();
             pdata.MaxOutlineWidth = rv->MaxOutlineWidth;
             pdata.Flags = rv->GetFlags();
 
@@ -3377,15 +4236,67 @@ static void renderCompositor(const TKit::TierArray<RenderView<D> *> &views, cons
         const VkRect2D scissor = AsVulkanScissor(sc);
 
         const VkViewport viewport = AsVulkanViewport(vp);
-        const u32 idx = rv->GetAttachmentIndex();
+
+        CompositorPushConstantData pdata;
+        pdata.AttachmentIndex = rv->GetAttachmentIndex();
+        pdata.UvScale = rv->GetResolutionUvScale();
 
         table->CmdSetViewport(cmd, 0, 1, &viewport);
         table->CmdSetScissor(cmd, 0, 1, &scissor);
-        table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(u32), &idx);
+        table->CmdPushConstants(cmd, playout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(CompositorPushConstantData),
+                                &pdata);
         table->CmdDraw(cmd, 6, 1, 0, 0);
     }
 }
 
+// returns the only visible view of the list, or null if there are none or more than one. the second parameter tells
+// whether more than one was found
+template <Dimension D>
+static RenderView<D> *findSingleVisibleView(const TKit::TierArray<RenderView<D> *> &views, bool &many)
+{
+    RenderView<D> *single = nullptr;
+    for (RenderView<D> *rv : views)
+        if (!(rv->GetFlags() & RenderViewFlag_Hidden))
+        {
+            if (single)
+            {
+                many = true;
+                return nullptr;
+            }
+            single = rv;
+        }
+    return single;
+}
+
+// opaque draws with an alpha below one are not blended in the view, but by the compositor over the target. a plain
+// copy would lose that, so those views must still be composited
+template <Dimension D> static bool hasTranslucentOpaqueDraws(const RenderView<D> *rv)
+{
+    const RendererData<D> &rdata = getRendererData<D>();
+    const ViewMask viewBit = rv->GetViewBit();
+    for (const ContextInfo<D> &info : rdata.Contexts)
+        if ((info.Context->GetViewMask() & viewBit) && info.Context->HasTranslucentOpaqueDraws())
+            return true;
+    return false;
+}
+
+// when only one view is visible and it covers the whole target, the compositor pass amounts to a plain copy of its
+// final attachment. returns that attachment so that the target can copy it directly instead
+static VKit::DeviceImage *findDirectCopySource(const RenderTargetInfo &tinfo)
+{
+    bool many = false;
+    RenderView<D2> *rv2 = findSingleVisibleView(tinfo.Views2, many);
+    RenderView<D3> *rv3 = findSingleVisibleView(tinfo.Views3, many);
+    if (many || (rv2 && rv3))
+        return nullptr;
+
+    if (rv2 && rv2->CoversParent() && !hasTranslucentOpaqueDraws(rv2))
+        return &rv2->GetFinalAttachment();
+    if (rv3 && rv3->CoversParent() && !hasTranslucentOpaqueDraws(rv3))
+        return &rv3->GetFinalAttachment();
+    return nullptr;
+}
+
 template <typename Target>
 RenderSubmitInfo render(VKit::Queue *graphics, const VkCommandBuffer cmd, Target *target, const RenderFlags flags)
 {
@@ -3409,13 +4320,17 @@ RenderSubmitInfo render(VKit::Queue *graphics, const VkCommandBuffer cmd, Target
     else
         target->MarkWriteImageInUse(tracker);
 
-    target->BeginRendering(cmd);
+    VKit::DeviceImage *source = findDirectCopySource(tinfo);
+    target->BeginRendering(cmd, source);
 
-    s_CompositorPipeline.Bind(cmd);
+    if (!source)
+    {
+        s_CompositorPipeline.Bind(cmd);
 
-    const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout(StandalonePass_Compositor);
-    renderCompositor(tinfo.Views2, cmd, playout);
-    renderCompositor(tinfo.Views3, cmd, playout);
+        const VKit::PipelineLayout &playout = Pipelines::GetPipelineLayout(StandalonePass_Compositor);
+        renderCompositor(tinfo.Views2, cmd, playout);
+        renderCompositor(tinfo.Views3, cmd, playout);
+    }
 
 #ifdef ONYX_ENABLE_IMGUI
     if constexpr (std::is_same_v<Target, Window>)
@@ -3430,7 +4345,7 @@ RenderSubmitInfo render(VKit::Queue *graphics, const VkCommandBuffer cmd, Target
 #endif
 
     target->EndRendering(cmd);
-    return createRenderSubmitInfo(graphics, cmd, graphicsFlight, tinfo, transferTrackers);
+    return createRenderSubmitInfo(graphics, cmd, graphicsFlight, tinfo, transferTrackers, source != nullptr);
 }
 
 RenderSubmitInfo Render(VKit::Queue *graphics, const VkCommandBuffer cmd, Window *window, const RenderFlags flags)
@@ -3490,14 +4405,86 @@ void SubmitRender(VKit::Queue *graphics, CommandPool *pool, const TKit::Span<con
     ONYX_CHECK_VKIT_RESULT(graphics->Submit2(submits));
 }
 
-template <typename Range, typename F> static void coalesceRanges(Pool<Range> &pool, F &&isInUse)
+// when coalescing within a time budget, the clock is checked once every this many ranges
+static constexpr u32 s_CoalesceTimedWindow = 64;
+
+// bounds the work of a coalesce call. pools are walked a window of ranges at a time, and each pool resumes its walk
+// where the previous call left it
+struct CoalesceTracker
+{
+    CoalesceTracker(const CoalesceBudget &budget)
+        : MaxTime(TKit::Timespan::FromSeconds(1e-6f * f32(budget.MaxMicroseconds))),
+          RangesLeft(budget.MaxRanges != 0 ? budget.MaxRanges : TKIT_U32_MAX), Timed(budget.MaxMicroseconds != 0)
+    {
+    }
+
+    bool IsExhausted() const
+    {
+        return RangesLeft == 0 || (Timed && Clock.GetElapsed() >= MaxTime);
+    }
+
+    // windows span at least two ranges so that a free range at the end of the previous window, which is always
+    // revisited, can still be merged with the one that follows
+    u32 ConsumeWindow(const u32 remaining)
+    {
+        u32 window = Math::Min(remaining, RangesLeft);
+        if (Timed)
+            window = Math::Min(window, s_CoalesceTimedWindow);
+        window = Math::Max(window, Math::Min(remaining, 2U));
+
+        RangesLeft -= Math::Min(window, RangesLeft);
+        return window;
+    }
+
+    TKit::Clock Clock{};
+    TKit::Timespan MaxTime{};
+    u32 RangesLeft;
+    bool Timed;
+};
+
+// replaces the ranges in [begin, end) with the new ones, shifting the ranges that follow
+template <typename Range>
+static void spliceRanges(TKit::TierArray<Range> &ranges, const u32 begin, const u32 end,
+                         TKit::StackArray<Range> &nranges)
+{
+    const u32 count = end - begin;
+    const u32 ncount = nranges.GetSize();
+    for (u32 i = 0; i < Math::Min(count, ncount); ++i)
+        ranges[begin + i] = std::move(nranges[i]);
+
+    if (ncount > count)
+        ranges.Insert(ranges.begin() + end, nranges.begin() + count, nranges.end());
+    else if (ncount < count)
+    {
+        const u32 size = ranges.GetSize();
+        for (u32 i = end; i < size; ++i)
+            ranges[i - count + ncount] = std::move(ranges[i]);
+        for (u32 i = ncount; i < count; ++i)
+            ranges.Pop();
+    }
+}
+
+// the walk resumes right after the coalesced window, unless it ended with a free range, which may still be merged with
+// the ones that follow
+template <typename Range>
+static u32 getNextCoalesceCursor(const TKit::TierArray<Range> &ranges, const u32 begin, const u32 ncount,
+                                 const bool endsFree)
+{
+    const u32 next = begin + ncount;
+    return endsFree && next < ranges.GetSize() ? next - 1 : next;
+}
+
+template <typename Range, typename F>
+static u32 coalesceRangeWindow(TKit::TierArray<Range> &pranges, const u32 begin, const u32 end, F &&isInUse)
 {
     Range mergeRange{};
+    mergeRange.Offset = pranges[begin].Offset;
     TKit::StackArray<Range> ranges{};
-    ranges.Reserve(pool.Ranges.GetSize());
+    ranges.Reserve(end - begin);
 
-    for (const Range &range : pool.Ranges)
+    for (u32 i = begin; i < end; ++i)
     {
+        const Range &range = pranges[i];
         if (isInUse(range))
         {
             if (mergeRange.Size != 0)
@@ -3513,28 +4500,34 @@ template <typename Range, typename F> static void coalesceRanges(Pool<Range> &po
         else
             mergeRange.Size += range.Size;
     }
-    if (mergeRange.Size != 0)
+    const bool endsFree = mergeRange.Size != 0;
+    if (endsFree)
         ranges.Append(mergeRange);
 
-    TKIT_ASSERT(!ranges.IsEmpty(),
-                "[ONYX][RENDERER] All memory ranges for a pool have been removed after coalesce operation!");
-    pool.Ranges = ranges;
+    const u32 ncount = ranges.GetSize();
+    spliceRanges(pranges, begin, end, ranges);
+    return getNextCoalesceCursor(pranges, begin, ncount, endsFree);
 }
 
-template <typename Range> static void coalesceRanges(Pool<Range> &pool)
-{
-    coalesceRanges(pool, [](const Range &range) { return range.Tracker.InUse(); });
-}
-
-template <Dimension D> static void coalesceGraphicsInstanceRanges(GraphicsInstancePool &gpool, const u32 maxRanges)
+template <Dimension D>
+static u32 coalesceGraphicsInstanceRangeWindow(TKit::TierArray<GraphicsInstanceRange> &pranges, const u32 begin,
+                                               const u32 end)
 {
     const RendererData<D> &rdata = getRendererData<D>();
     GraphicsInstanceRange gmergeRange{};
+    gmergeRange.Offset = pranges[begin].Offset;
+
+    // a range may be split around each of its dirty context ranges
+    u32 capacity = 1;
+    for (u32 i = begin; i < end; ++i)
+        capacity += 2 * pranges[i].ContextRanges.GetSize() + 1;
+
     TKit::StackArray<GraphicsInstanceRange> granges{};
-    granges.Reserve(maxRanges);
+    granges.Reserve(capacity);
 
-    for (const GraphicsInstanceRange &grange : gpool.Ranges)
+    for (u32 i = begin; i < end; ++i)
     {
+        const GraphicsInstanceRange &grange = pranges[i];
         if (grange.InUse())
         {
             if (gmergeRange.Size != 0)
@@ -3587,7 +4580,7 @@ template <Dimension D> static void coalesceGraphicsInstanceRanges(GraphicsInstan
                         granges.Append(ngrange);
                         ngrange.Offset += ngrange.Size + crange.Size;
                         ngrange.Size = 0;
-                        ngrange.ViewMask = 0;
+                        ngrange.ViewMask = {};
                         cranges.Clear();
                     }
                     else
@@ -3605,65 +4598,176 @@ template <Dimension D> static void coalesceGraphicsInstanceRanges(GraphicsInstan
         else
             gmergeRange.Size += grange.Size;
     }
-    if (gmergeRange.Size != 0)
+    const bool endsFree = gmergeRange.Size != 0;
+    if (endsFree)
         granges.Append(gmergeRange);
 
-    TKIT_ASSERT(!granges.IsEmpty(),
-                "[ONYX][RENDERER] All memory ranges for the graphics pool have been removed after coalesce operation!");
-    gpool.Ranges = granges;
+    const u32 ncount = granges.GetSize();
+    spliceRanges(pranges, begin, end, granges);
+    return getNextCoalesceCursor(pranges, begin, ncount, endsFree);
 }
 
-template <Dimension D> void coalesce(const u32 maxRanges)
+// walks the pool a window at a time until the budget runs out. returns true once the walk reaches the end of the pool,
+// in which case it starts over from the beginning the next time
+template <typename Range, typename F>
+static bool coalescePool(Pool<Range> &pool, CoalesceTracker &tracker, F &&coalesceWindow)
+{
+    TKit::TierArray<Range> &ranges = pool.Ranges;
+    if (pool.CoalesceCursor >= ranges.GetSize())
+        pool.CoalesceCursor = 0;
+
+    while (!tracker.IsExhausted())
+    {
+        const u32 begin = pool.CoalesceCursor;
+        const u32 end = begin + tracker.ConsumeWindow(ranges.GetSize() - begin);
+        pool.CoalesceCursor = coalesceWindow(ranges, begin, end);
+
+        TKIT_ASSERT(!ranges.IsEmpty(),
+                    "[ONYX][RENDERER] All memory ranges for a pool have been removed after coalesce operation!");
+        if (pool.CoalesceCursor >= ranges.GetSize())
+        {
+            pool.CoalesceCursor = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Range, typename F>
+static bool coalesceRanges(Pool<Range> &pool, CoalesceTracker &tracker, F &&isInUse)
+{
+    return coalescePool(pool, tracker, [&isInUse](TKit::TierArray<Range> &ranges, const u32 begin, const u32 end) {
+        return coalesceRangeWindow(ranges, begin, end, isInUse);
+    });
+}
+
+template <typename Range> static bool coalesceRanges(Pool<Range> &pool, CoalesceTracker &tracker)
+{
+    return coalesceRanges(pool, tracker, [](const Range &range) { return range.Tracker.InUse(); });
+}
+
+template <Dimension D> static bool coalesceGraphicsInstanceRanges(GraphicsInstancePool &gpool, CoalesceTracker &tracker)
+{
+    return coalescePool(gpool, tracker,
+                        [](TKit::TierArray<GraphicsInstanceRange> &ranges, const u32 begin, const u32 end) {
+                            return coalesceGraphicsInstanceRangeWindow<D>(ranges, begin, end);
+                        });
+}
+
+template <Dimension D> static constexpr u32 getCoalescePoolCount()
+{
+    return 2 * (u32(Geometry_Count) + LightTypeCount<D> + u32(ContextTable_Count)) + 4;
+}
+
+// pools are coalesced one after the other in a fixed order, each identified by its index in that order
+template <Dimension D> static bool coalescePoolAt(u32 index, CoalesceTracker &tracker)
 {
-#ifdef TKIT_ENABLE_ENSURE
-    validateRanges<D>();
-#endif
     RendererData<D> &rdata = getRendererData<D>();
-    for (InstanceArena &arena : rdata.Geometry.Arenas)
+    if (index < 2 * u32(Geometry_Count))
     {
-        coalesceRanges(arena.Transfer);
-        coalesceGraphicsInstanceRanges<D>(arena.Graphics, maxRanges);
+        InstanceArena &arena = rdata.Geometry.Arenas[index / 2];
+        return index % 2 == 0 ? coalesceRanges(arena.Transfer, tracker)
+                              : coalesceGraphicsInstanceRanges<D>(arena.Graphics, tracker);
     }
-    LightData<D> &ldata = rdata.Lights;
-    for (LightArena &arena : ldata.Arenas)
+    index -= 2 * u32(Geometry_Count);
+
+    if (index < 2 * LightTypeCount<D>)
     {
-        coalesceRanges(arena.Transfer);
-        coalesceRanges(arena.Graphics, [&arena](const GraphicsRange &grange) {
+        LightArena &arena = rdata.Lights.Arenas[index / 2];
+        if (index % 2 == 0)
+            return coalesceRanges(arena.Transfer, tracker);
+        return coalesceRanges(arena.Graphics, tracker, [&arena](const GraphicsRange &grange) {
             return grange.Generation == arena.ActiveGeneration || grange.InUse();
         });
     }
+    index -= 2 * LightTypeCount<D>;
 
-    coalesceRanges(rdata.Geometry.VertexArena.Transfer);
-    coalesceRanges(rdata.Geometry.IndexArena.Transfer);
+    if (index < 2 * u32(ContextTable_Count))
+    {
+        const ContextTable table = ContextTable(index / 2);
+        Arena &arena = rdata.TableArenas[table];
+        if (index % 2 == 0)
+            return coalesceRanges(arena.Transfer, tracker);
+        return coalesceRanges(arena.Graphics, tracker, [&rdata, table](const GraphicsRange &tgrange) {
+            return tgrange.InUse() || rdata.IsTableRangeReferenced(table, tgrange);
+        });
+    }
+    index -= 2 * u32(ContextTable_Count);
 
+    switch (index)
+    {
+    case 0:
+        return coalesceRanges(rdata.Geometry.VertexArena.Transfer, tracker);
+    case 1:
+        return coalesceRanges(rdata.Geometry.IndexArena.Transfer, tracker);
     // NOTE(Isma): This is NOT ideal at all
-    coalesceRanges(rdata.Geometry.VertexArena.Graphics, [&](const GraphicsRange &vgrange) {
-        if (vgrange.InUse())
-            return true;
-        for (const GraphicsInstanceRange &grange : rdata.Geometry.Arenas[Geometry_Dynamic].Graphics.Ranges)
-            if (grange.ActiveVertexGeneration == vgrange.Generation)
+    case 2:
+        return coalesceRanges(rdata.Geometry.VertexArena.Graphics, tracker, [&](const GraphicsRange &vgrange) {
+            if (vgrange.InUse())
                 return true;
-        return false;
-    });
-    coalesceRanges(rdata.Geometry.IndexArena.Graphics, [&](const GraphicsRange &vgrange) {
-        if (vgrange.InUse())
-            return true;
-        for (const GraphicsInstanceRange &grange : rdata.Geometry.Arenas[Geometry_Dynamic].Graphics.Ranges)
-            if (grange.ActiveIndexGeneration == vgrange.Generation)
+            for (const GraphicsInstanceRange &grange : rdata.Geometry.Arenas[Geometry_Dynamic].Graphics.Ranges)
+                if (grange.ActiveVertexGeneration == vgrange.Generation)
+                    return true;
+            return false;
+        });
+    case 3:
+        return coalesceRanges(rdata.Geometry.IndexArena.Graphics, tracker, [&](const GraphicsRange &vgrange) {
+            if (vgrange.InUse())
                 return true;
-        return false;
-    });
+            for (const GraphicsInstanceRange &grange : rdata.Geometry.Arenas[Geometry_Dynamic].Graphics.Ranges)
+                if (grange.ActiveIndexGeneration == vgrange.Generation)
+                    return true;
+            return false;
+        });
+    default:
+        TKIT_FATAL("[ONYX][RENDERER] Unrecognized coalesce pool index: {}", index);
+        return true;
+    }
+}
 
+// returns true once every pool has been walked to its end since the sweep started
+template <Dimension D> static bool coalesce(CoalesceTracker &tracker)
+{
 #ifdef TKIT_ENABLE_ENSURE
     validateRanges<D>();
 #endif
+    RendererData<D> &rdata = getRendererData<D>();
+    bool finished = true;
+    for (; rdata.CoalescePool < getCoalescePoolCount<D>(); ++rdata.CoalescePool)
+        if (!coalescePoolAt<D>(rdata.CoalescePool, tracker))
+        {
+            finished = false;
+            break;
+        }
+    if (finished)
+        rdata.CoalescePool = 0;
+
+#ifdef TKIT_ENABLE_ENSURE
+    validateRanges<D>();
+#endif
+    return finished;
 }
 
-void Coalesce(const u32 maxRanges)
+template <Dimension First, Dimension Second> static void coalesceInOrder(CoalesceTracker &tracker)
+{
+    if (coalesce<First>(tracker))
+    {
+        getRendererData<First>().CoalesceYield = true;
+        getRendererData<Second>().CoalesceYield = false;
+    }
+    coalesce<Second>(tracker);
+}
+
+void Coalesce(const CoalesceBudget &budget)
 {
     TKIT_PROFILE_NSCOPE("Onyx::Renderer::Coalesce");
-    coalesce<D2>(maxRanges);
-    coalesce<D3>(maxRanges);
+    CoalesceTracker tracker{budget};
+
+    // the dimension whose sweep is unfinished resumes first, so that a tight budget does not starve the other one
+    if (getRendererData<D2>().CoalesceYield)
+        coalesceInOrder<D3, D2>(tracker);
+    else
+        coalesceInOrder<D2, D3>(tracker);
 }
 
 template <typename... Args> static TKit::StackString fmt(fmt::format_string<Args...> str, Args &&...args)
@@ -3717,8 +4821,7 @@ static void displayRanges(Overlay *ov, const TKit::StringView name, const Pool<R
 
                     if (range.RenderFlags != 0)
                         ov->Text("Render mode: {}", ToString(GetRenderMode(range.RenderFlags)));
-                    const TKit::StackString vmask = TKit::StackString::Format("{:032b}", range.ViewMask);
-                    ov->Text("View mask: {}", vmask.CString());
+                    ov->Text("View mask: {}", formatViewMask(range.ViewMask).CString());
                     if (ov->PushTree({&range.ContextRanges, fmt("Context ranges ({})", range.ContextRanges.GetSize())},
                                      s_DrawLines))
                     {
@@ -3737,8 +4840,7 @@ static void displayRanges(Overlay *ov, const TKit::StringView name, const Pool<R
                                 else
                                     ov->Text("Context index: None");
 
-                                const TKit::StackString cvmask = TKit::StackString::Format("{:032b}", crange.ViewMask);
-                                ov->Text("View mask: %s", cvmask.CString());
+                                ov->Text("View mask: {}", formatViewMask(crange.ViewMask).CString());
                                 ov->PopTree();
                             }
                         ov->PopTree();
@@ -3916,7 +5018,10 @@ template <Dimension D> void DisplayMemoryLayout(Overlay *ov)
     const LightData<D> &ldata = rdata.Lights;
     ov->PushId(&rdata);
     if (ov->Button("Coalesce##Button"))
-        coalesce<D>(512);
+    {
+        CoalesceTracker tracker{CoalesceBudget{}};
+        coalesce<D>(tracker);
+    }
 
     for (u32 i = 0; i < Geometry_Count; ++i)
     {
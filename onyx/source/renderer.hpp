@@ -4,6 +4,7 @@
 #include "onyx/window.hpp"
 #include "onyx/render_texture.hpp"
 #include "onyx/instance.hpp"
+#include "onyx/view_mask.hpp"
 #include "execution.hpp"
 #include "pass.hpp"
 #include "vkit/execution/queue.hpp"
@@ -57,11 +58,16 @@ template <Dimension D> RenderContext<D> *CreateContext(u32 immediateDynamicMeshC
 template <Dimension D> void DestroyContext(const RenderContext<D> *context);
 void FlushAllContexts();
 void ReloadPipelines();
+
+// latest generation at which any context targeting one of the views in the mask was transferred. if it did not grow
+// since the last frame, the contents of those views did not change
+u64 GetViewGeneration(const ViewMask &vmask);
 bool IsDepthSupportedFor2D();
+bool HasQuantizedStaticMeshes();
 
 // TODO(Isma): Remove this. will not be necessary, onyx.hpp handles it
-void AddTarget(const ViewMask vmask);
-void RemoveTarget(const ViewMask vmask);
+void AddTarget(const ViewMask &vmask);
+void RemoveTarget(const ViewMask &vmask);
 
 // TODO(Isma): Add a bit more clearance on what these do. They essentially write into the renderer's descriptor sets
 template <Dimension D>
@@ -70,6 +76,8 @@ template <Dimension D>
 void BindImage(u32 binding, TKit::Span<const VkDescriptorImageInfo> info, RenderPass pass, u32 dstElement = 0);
 
 const VKit::Sampler &GetNearSampler();
+// linear filtering clamped to edge, used to stretch views rendered at a lower resolution back to their viewport
+const VKit::Sampler &GetUpscaleSampler();
 
 template <Dimension D> const ten<VkDescriptorSet, Geometry_Count> &GetDescriptorSets(RenderPass pass);
 
@@ -89,6 +97,16 @@ RenderSubmitInfo Render(VKit::Queue *graphics, VkCommandBuffer command, Window *
 RenderSubmitInfo Render(VKit::Queue *graphics, VkCommandBuffer command, RenderTexture *rtex);
 
 void SubmitRender(VKit::Queue *graphics, CommandPool *pool, TKit::Span<const RenderSubmitInfo> info);
-void Coalesce(u32 maxRanges = 512);
+struct CoalesceBudget
+{
+    // maximum amount of memory ranges walked by a single call. zero means no limit
+    u32 MaxRanges = 0;
+    // maximum time spent by a single call, checked every few ranges so it may be slightly exceeded. zero means no limit
+    u32 MaxMicroseconds = 0;
+};
+
+// merges the free neighbouring ranges of every memory pool. the walk is incremental: once the budget runs out, the next
+// call resumes it where this one stopped
+void Coalesce(const CoalesceBudget &budget = {});
 
 } // namespace Onyx::Renderer
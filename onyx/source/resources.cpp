@@ -5,6 +5,7 @@
 #include "renderer.hpp"
 #include "core.hpp"
 #include "buffer.hpp"
+#include "vertex.hpp"
 #include "vkit/state/descriptor_set.hpp"
 #include "vkit/resource/sampler.hpp"
 #include "vkit/resource/device_buffer.hpp"
@@ -59,6 +60,9 @@ template <typename Vertex> struct MeshDataInfo
     MeshDataLayout Layout;
     Resource Bounds;
     MeshDataFlags Flags;
+    // levels of detail are registered right after their base mesh, in the same pool
+    u32 LodCount = 0;
+    f32 LodCoverage = 0.f;
 };
 
 template <Dimension D> struct MeshDataInfo<ParametricVertex<D>>
@@ -81,9 +85,19 @@ template <typename Vertex> struct MeshPoolData
 {
     VKit::DeviceBuffer VertexBuffer{};
     VKit::DeviceBuffer IndexBuffer{};
+    VKit::DeviceBuffer ShortIndexBuffer{};
     TKit::DynamicArray<Vertex> Vertices{};
+    // device copy of the vertices of static 3D pools when quantization is enabled. the full precision vertices are kept
+    // on the host so that meshes can still be read back and updated
+    TKit::DynamicArray<QuantizedStaticVertex3> QuantizedVertices{};
     TKit::DynamicArray<Index> Indices{};
+    // indices of the meshes that can address all of their vertices with 16 bits
+    TKit::DynamicArray<u16> ShortIndices{};
     TKit::TierArray<MeshDataInfo<Vertex>> Meshes{};
+    // where the pool starts in the unified buffers. zero and unused when each pool owns its buffers
+    u32 VertexOffset = 0;
+    u32 IndexOffset = 0;
+    u32 ShortIndexOffset = 0;
     StatusFlags Flags = 0;
 };
 
@@ -91,6 +105,10 @@ template <typename Vertex> struct MeshResourceData
 {
     TKit::StaticHive<MeshPoolData<Vertex>, ONYX_MAX_RESOURCE_POOLS> Pools{};
     TKit::StaticArray<ResourcePool, ONYX_MAX_RESOURCE_POOLS> ToDestroy{};
+    // only created with unified mesh buffers, in which case the pools do not create their own
+    VKit::DeviceBuffer VertexBuffer{};
+    VKit::DeviceBuffer IndexBuffer{};
+    VKit::DeviceBuffer ShortIndexBuffer{};
 };
 
 template <> struct MeshPoolData<GlyphVertex>
@@ -180,6 +198,9 @@ static TKit::Storage<ImageResourceData> s_Images{};
 static TKit::Storage<TextureResourceData> s_Textures{};
 static TKit::Storage<FontResourceData> s_FontData{};
 static DefaultResources s_DefaultResources{};
+static bool s_UnifiedMeshBuffers = false;
+// increased whenever a resource that may be sampled or drawn changes, so that idle windows know they must render again
+static u64 s_Generation = 0;
 
 template <Dimension D> static ResourceData<D> &getData()
 {
@@ -238,6 +259,26 @@ static void updateTextureOffsetsDescriptorSet()
     Renderer::BindBuffer<D3>(ONYX_TEXTURE_OFFSETS_BINDING_POINT, info, RenderPass_Flat);
 }
 
+template <typename Vertex> static void createUnifiedMeshBuffers(MeshResourceData<Vertex> &meshes)
+{
+    meshes.VertexBuffer = Onyx::CreateBuffer<Vertex>(Buffer_DeviceVertex);
+    meshes.IndexBuffer = Onyx::CreateBuffer<Index>(Buffer_DeviceIndex);
+    meshes.ShortIndexBuffer = Onyx::CreateBuffer<u16>(Buffer_DeviceIndex);
+    if (IsDebugUtilsEnabled())
+    {
+        const TKit::StackString vb = TKit::StackString::Format("onyx-resources-unified-vertex-buffer-{}D-'{}'",
+                                                               u8(Vertex::Dim), ToString(Vertex::Resource));
+        const TKit::StackString ib = TKit::StackString::Format("onyx-resources-unified-index-buffer-{}D-'{}'",
+                                                               u8(Vertex::Dim), ToString(Vertex::Resource));
+        const TKit::StackString sib = TKit::StackString::Format("onyx-resources-unified-short-index-buffer-{}D-'{}'",
+                                                                u8(Vertex::Dim), ToString(Vertex::Resource));
+
+        ONYX_CHECK_VKIT_RESULT(meshes.VertexBuffer.SetName(vb.CString()));
+        ONYX_CHECK_VKIT_RESULT(meshes.IndexBuffer.SetName(ib.CString()));
+        ONYX_CHECK_VKIT_RESULT(meshes.ShortIndexBuffer.SetName(sib.CString()));
+    }
+}
+
 // TODO(Isma): If there is a max bounds and material... why allow resizes on its buffer. Remove the resize path,
 // allocate enough memory from the beginning. Remove the flags from the descriptor, the update after bind thing. Update
 // only ONCE the descriptors here, in initialize
@@ -271,6 +312,15 @@ void Initialize(const Specs &specs)
     s_ResourceData2->DynamicMeshes.Reserve(specs.MaxDynamicMeshes);
     s_ResourceData3->DynamicMeshes.Reserve(specs.MaxDynamicMeshes);
 
+    s_UnifiedMeshBuffers = specs.UnifiedMeshBuffers;
+    if (s_UnifiedMeshBuffers)
+    {
+        createUnifiedMeshBuffers(s_ResourceData2->StaticMeshes);
+        createUnifiedMeshBuffers(s_ResourceData2->ParametricMeshes);
+        createUnifiedMeshBuffers(s_ResourceData3->StaticMeshes);
+        createUnifiedMeshBuffers(s_ResourceData3->ParametricMeshes);
+    }
+
     initializeMaterials<D2>(specs.MaxMaterials);
     initializeMaterials<D3>(specs.MaxMaterials);
     initializeBounds<D2>(specs.MaxBounds);
@@ -283,7 +333,11 @@ template <typename Vertex> static void terminateMeshes(MeshResourceData<Vertex>
     {
         pool.VertexBuffer.Destroy();
         pool.IndexBuffer.Destroy();
+        pool.ShortIndexBuffer.Destroy();
     }
+    meshData.VertexBuffer.Destroy();
+    meshData.IndexBuffer.Destroy();
+    meshData.ShortIndexBuffer.Destroy();
 }
 template <Dimension D> static void terminateMaterials()
 {
@@ -479,6 +533,7 @@ void UpdateSampler(const Resource handle, const SamplerData &data)
                                                             .SetAddressModeW(asVulkanAddressMode(data.WrapW))
                                                             .Build());
     bindSampler(handle);
+    ++s_Generation;
 }
 
 void DestroySampler(const Resource handle)
@@ -492,6 +547,7 @@ void DestroySampler(const Resource handle)
     const u32 sid = GetResourceId(handle);
     s_Samplers->Resources[sid].Destroy();
     s_Samplers->Resources.Remove(sid);
+    ++s_Generation;
 }
 
 void ReleaseSampler(const Resource handle)
@@ -594,6 +650,7 @@ void DestroyImage(const Resource handle)
     img.Image.Destroy();
     const u32 iid = GetResourceId(handle);
     s_Images->Resources.Remove(iid);
+    ++s_Generation;
 }
 
 void UpdateImage(const Resource handle, const ImageData &data)
@@ -606,6 +663,7 @@ void UpdateImage(const Resource handle, const ImageData &data)
 
     img.Image.Destroy();
     img.Image = createImage(data);
+    ++s_Generation;
 }
 
 void ReleaseImage(const Resource handle)
@@ -714,6 +772,7 @@ static void destroyTexture(const Resource handle)
         s_Textures->Offsets.Remove(tex.OffsetId);
 
     s_Textures->Resources.Remove(tid);
+    ++s_Generation;
 }
 
 #ifdef TKIT_ENABLE_ENSURE
@@ -781,6 +840,7 @@ void UpdateTexture(const Resource handle, const Resource image, const u32 viewIn
     const VkImageView view =
         viewIndex == TKIT_U32_MAX ? ONYX_CHECK_VKIT_RESULT(img.AddImageView()) : img.GetView(viewIndex);
     updateTexture(image, view, handle);
+    ++s_Generation;
 }
 
 void UpdateRenderTexture(const Resource handle, const VkImageView view)
@@ -825,8 +885,45 @@ template <Dimension D> static void destroyBounds(const Resource handle)
     destroyHiveResource(handle, getData<D>().BoundingBoxes);
 }
 
+// index values are local to each mesh because draws offset them by the start of its vertices, so any mesh with few
+// enough vertices can store them with 16 bits no matter where it lands in its pool
+static bool usesShortIndices(const u32 vertexCount)
+{
+    return sizeof(Index) > sizeof(u16) && vertexCount <= (1U << 16);
+}
+
+template <typename Vertex> static bool usesQuantizedVertices()
+{
+    if constexpr (std::is_same_v<Vertex, StaticVertex<D3>>)
+        return Renderer::HasQuantizedStaticMeshes();
+    else
+        return false;
+}
+
+template <typename Vertex>
+static void quantizeVertices(MeshPoolData<Vertex> &mpool, const MeshData<Vertex> &data, const u32 vertexStart,
+                             const BoundsData<Vertex::Dim> &bounds)
+{
+    if constexpr (std::is_same_v<Vertex, StaticVertex<D3>>)
+        for (u32 i = 0; i < data.Vertices.GetSize(); ++i)
+            mpool.QuantizedVertices[vertexStart + i] = QuantizeStaticVertex(data.Vertices[i], bounds);
+}
+
+// quantizes again vertices already stored in the pool
 template <typename Vertex>
-static Resource createMesh(const ResourcePool pool, MeshResourceData<Vertex> &meshes, const MeshData<Vertex> &data)
+static void requantizeVertices(MeshPoolData<Vertex> &mpool, const MeshDataLayout &layout,
+                               const BoundsData<Vertex::Dim> &bounds)
+{
+    if constexpr (std::is_same_v<Vertex, StaticVertex<D3>>)
+        for (u32 i = layout.VertexStart; i < layout.VertexStart + layout.VertexCount; ++i)
+            mpool.QuantizedVertices[i] = QuantizeStaticVertex(mpool.Vertices[i], bounds);
+}
+
+// levels of detail pass the bounds of their base mesh, so that they are quantized within the same box and a single
+// bounds handle serves the whole chain
+template <typename Vertex>
+static Resource createMesh(const ResourcePool pool, MeshResourceData<Vertex> &meshes, const MeshData<Vertex> &data,
+                           const Resource sharedBounds = NullHandle)
 {
     constexpr ResourceType rtype = Vertex::Resource;
     CHECK_POOL_HANDLE_WITH_DIM(pool, rtype, Vertex::Dim);
@@ -838,23 +935,38 @@ static Resource createMesh(const ResourcePool pool, MeshResourceData<Vertex> &me
 
     const u32 mid = mpool.Meshes.GetSize();
     const u32 vcount = mpool.Vertices.GetSize();
-    const u32 icount = mpool.Indices.GetSize();
+    const bool shortIndices = usesShortIndices(data.Vertices.GetSize());
+    const u32 icount = shortIndices ? mpool.ShortIndices.GetSize() : mpool.Indices.GetSize();
+
+    const BoundsData<Vertex::Dim> bounds =
+        sharedBounds == NullHandle ? CreateBoundsData(data) : GetBoundsData<Vertex::Dim>(sharedBounds);
 
     MeshDataInfo<Vertex> &minfo = mpool.Meshes.Append();
     minfo.Layout.VertexStart = vcount;
     minfo.Layout.VertexCount = data.Vertices.GetSize();
     minfo.Layout.IndexStart = icount;
     minfo.Layout.IndexCount = data.Indices.GetSize();
-    minfo.Bounds = createBounds(CreateBoundsData(data));
+    minfo.Bounds = sharedBounds == NullHandle ? createBounds(bounds) : sharedBounds;
     minfo.Flags = data.Flags;
 
     if constexpr (Vertex::Geo == Geometry_Parametric)
         minfo.Shape = data.Shape;
 
     auto &vertices = mpool.Vertices;
-    auto &indices = mpool.Indices;
     vertices.Insert(vertices.end(), data.Vertices.begin(), data.Vertices.end());
-    indices.Insert(indices.end(), data.Indices.begin(), data.Indices.end());
+    if (usesQuantizedVertices<Vertex>())
+    {
+        mpool.QuantizedVertices.Resize(vertices.GetSize());
+        quantizeVertices(mpool, data, vcount, bounds);
+    }
+    if (shortIndices)
+        for (const Index idx : data.Indices)
+            mpool.ShortIndices.Append(u16(idx));
+    else
+    {
+        auto &indices = mpool.Indices;
+        indices.Insert(indices.end(), data.Indices.begin(), data.Indices.end());
+    }
     return CreateResourceHandle(rtype, mid, pid);
 }
 
@@ -876,10 +988,17 @@ static void updateMesh(const Resource handle, MeshResourceData<Vertex> &meshes,
                 "must be the "
                 "same. If they are not, you must create a new mesh");
 
-    updateBounds(minfo.Bounds, CreateBoundsData(data));
+    const BoundsData<Vertex::Dim> bounds = CreateBoundsData(data);
+    updateBounds(minfo.Bounds, bounds);
 
     TKit::ForwardCopy(mpool.Vertices.begin() + layout.VertexStart, data.Vertices.begin(), data.Vertices.end());
-    TKit::ForwardCopy(mpool.Indices.begin() + layout.IndexStart, data.Indices.begin(), data.Indices.end());
+    if (usesQuantizedVertices<Vertex>())
+        quantizeVertices(mpool, data, layout.VertexStart, bounds);
+    if (usesShortIndices(layout.VertexCount))
+        for (u32 i = 0; i < layout.IndexCount; ++i)
+            mpool.ShortIndices[layout.IndexStart + i] = u16(data.Indices[i]);
+    else
+        TKit::ForwardCopy(mpool.Indices.begin() + layout.IndexStart, data.Indices.begin(), data.Indices.end());
 
     if constexpr (Vertex::Geo == Geometry_Parametric)
         minfo.Shape = data.Shape;
@@ -989,6 +1108,34 @@ template <Dimension D> Resource RegisterMesh(const ResourcePool pool, const Stat
 {
     return createMesh(pool, getData<D>().StaticMeshes, data);
 }
+template <Dimension D>
+Resource RegisterMesh(const ResourcePool pool, const StaticMeshData<D> &data, const MeshLodSpecs &specs)
+{
+    StaticMeshResourceData<D> &meshes = getData<D>().StaticMeshes;
+    const Resource mesh = createMesh(pool, meshes, data);
+    const Resource bounds = GetMeshBounds<D>(mesh);
+
+    u32 lodCount = 0;
+    const u32 levels = Math::Min(specs.Levels, u32(ONYX_MAX_MESH_LODS));
+    StaticMeshData<D> lod = data;
+    for (u32 i = 0; i < levels; ++i)
+    {
+        const u32 triangles = lod.Indices.GetSize() / 3;
+        lod = SimplifyMeshData(lod, u32(specs.Reduction * f32(triangles)));
+
+        // levels that barely shrink, or that collapse completely, are not worth drawing
+        const u32 lodTriangles = lod.Indices.GetSize() / 3;
+        if (lodTriangles == 0 || lodTriangles >= triangles)
+            break;
+        createMesh(pool, meshes, lod, bounds);
+        ++lodCount;
+    }
+
+    StaticMeshDataInfo<D> &minfo = meshes.Pools[GetResourcePoolId(mesh)].Meshes[GetResourceId(mesh)];
+    minfo.LodCount = lodCount;
+    minfo.LodCoverage = specs.Coverage;
+    return mesh;
+}
 template <Dimension D> Resource RegisterMesh(const ResourcePool pool, const ParametricMeshData<D> &data)
 {
     return createMesh(pool, getData<D>().ParametricMeshes, data);
@@ -1007,7 +1154,18 @@ template <Dimension D> void UpdateMaterial(const Resource handle, const Material
 
 template <Dimension D> void UpdateMesh(const Resource handle, const StaticMeshData<D> &data)
 {
-    return updateMesh(handle, getData<D>().StaticMeshes, data);
+    StaticMeshResourceData<D> &meshes = getData<D>().StaticMeshes;
+    updateMesh(handle, meshes, data);
+    if (!usesQuantizedVertices<StaticVertex<D>>())
+        return;
+
+    // the levels of detail are not regenerated, but they share the bounds of the base mesh, which may have changed
+    MeshPoolData<StaticVertex<D>> &mpool = meshes.Pools[GetResourcePoolId(handle)];
+    const u32 mid = GetResourceId(handle);
+    const StaticMeshDataInfo<D> &minfo = mpool.Meshes[mid];
+    const BoundsData<D> &bounds = GetBoundsData<D>(minfo.Bounds);
+    for (u32 i = 1; i <= minfo.LodCount; ++i)
+        requantizeVertices(mpool, mpool.Meshes[mid + i].Layout, bounds);
 }
 template <Dimension D> void UpdateMesh(const Resource handle, const ParametricMeshData<D> &data)
 {
@@ -1016,15 +1174,21 @@ template <Dimension D> void UpdateMesh(const Resource handle, const ParametricMe
 
 template <typename Vertex> static ResourcePool createMeshPool(const ResourceType rtype, MeshResourceData<Vertex> &data)
 {
+    const u32 pid = data.Pools.Insert();
+    const ResourcePool pool = CreateResourcePoolHandle(rtype, pid);
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        if (s_UnifiedMeshBuffers)
+            return pool;
+
     VKit::DeviceBuffer vbuffer = Onyx::CreateBuffer<Vertex>(Buffer_DeviceVertex);
     VKit::DeviceBuffer ibuffer = Onyx::CreateBuffer<Index>(Buffer_DeviceIndex);
 
-    const u32 pid = data.Pools.Insert();
     MeshPoolData<Vertex> &mpool = data.Pools[pid];
     mpool.VertexBuffer = vbuffer;
     mpool.IndexBuffer = ibuffer;
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        mpool.ShortIndexBuffer = Onyx::CreateBuffer<u16>(Buffer_DeviceIndex);
 
-    const ResourcePool pool = CreateResourcePoolHandle(rtype, pid);
     if (IsDebugUtilsEnabled())
     {
         const TKit::StackString vb = TKit::StackString::Format("onyx-resources-vertex-buffer-{:#010x}", pool);
@@ -1032,6 +1196,12 @@ template <typename Vertex> static ResourcePool createMeshPool(const ResourceType
 
         ONYX_CHECK_VKIT_RESULT(vbuffer.SetName(vb.CString()));
         ONYX_CHECK_VKIT_RESULT(ibuffer.SetName(ib.CString()));
+        if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        {
+            const TKit::StackString sib =
+                TKit::StackString::Format("onyx-resources-short-index-buffer-{:#010x}", pool);
+            ONYX_CHECK_VKIT_RESULT(mpool.ShortIndexBuffer.SetName(sib.CString()));
+        }
     }
 
     return pool;
@@ -1065,10 +1235,17 @@ template <typename Vertex> static void destroyMeshPool(const ResourcePool pool,
     const u32 pid = GetResourcePoolId(pool);
     MeshPoolData<Vertex> &mpool = meshes.Pools[pid];
     if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
-        for (const MeshDataInfo<Vertex> &minfo : mpool.Meshes)
-            destroyBounds<Vertex::Dim>(minfo.Bounds);
+        for (u32 i = 0; i < mpool.Meshes.GetSize(); ++i)
+        {
+            destroyBounds<Vertex::Dim>(mpool.Meshes[i].Bounds);
+            // levels of detail do not own their bounds
+            if constexpr (Vertex::Geo == Geometry_Static)
+                i += mpool.Meshes[i].LodCount;
+        }
     mpool.VertexBuffer.Destroy();
     mpool.IndexBuffer.Destroy();
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        mpool.ShortIndexBuffer.Destroy();
 
     meshes.Pools.Remove(pid);
 }
@@ -1268,7 +1445,11 @@ template <typename Vertex> static MeshData<Vertex> getMeshData(const Resource ha
     const u32 iend = istart + minfo.Layout.IndexCount;
 
     data.Vertices.Insert(data.Vertices.end(), mpool.Vertices.begin() + vstart, mpool.Vertices.begin() + vend);
-    data.Indices.Insert(data.Indices.end(), mpool.Indices.begin() + istart, mpool.Indices.begin() + iend);
+    if (usesShortIndices(minfo.Layout.VertexCount))
+        for (u32 i = istart; i < iend; ++i)
+            data.Indices.Append(Index(mpool.ShortIndices[i]));
+    else
+        data.Indices.Insert(data.Indices.end(), mpool.Indices.begin() + istart, mpool.Indices.begin() + iend);
     if constexpr (Vertex::Geo == Geometry_Parametric)
         data.Shape = minfo.Shape;
 
@@ -1368,7 +1549,14 @@ template <typename Vertex> static MeshDataLayout getMeshLayout(const Resource ha
     const u32 pid = GetResourcePoolId(handle);
     const u32 mid = GetResourceId(handle);
 
-    return meshes.Pools[pid].Meshes[mid].Layout;
+    const MeshPoolData<Vertex> &mpool = meshes.Pools[pid];
+    MeshDataLayout layout = mpool.Meshes[mid].Layout;
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+    {
+        layout.VertexStart += mpool.VertexOffset;
+        layout.IndexStart += usesShortIndices(layout.VertexCount) ? mpool.ShortIndexOffset : mpool.IndexOffset;
+    }
+    return layout;
 }
 
 MeshDataLayout GetFontLayout(const Resource handle)
@@ -1410,6 +1598,23 @@ template <Dimension D> MeshDataLayout GetMeshLayout(const Resource handle)
     }
 }
 
+template <Dimension D> Resource SelectMeshLod(const Resource handle, const f32 coverage)
+{
+    CHECK_RESOURCE_AND_POOL_HANDLES_WITH_DIM(handle, Resource_StaticMesh, D);
+    const u32 pid = GetResourcePoolId(handle);
+    const u32 mid = GetResourceId(handle);
+
+    const StaticMeshDataInfo<D> &minfo = getData<D>().StaticMeshes.Pools[pid].Meshes[mid];
+    u32 level = 0;
+    f32 threshold = minfo.LodCoverage;
+    while (level < minfo.LodCount && coverage < threshold)
+    {
+        ++level;
+        threshold *= 0.5f;
+    }
+    return level == 0 ? handle : CreateResourceHandle(Resource_StaticMesh, mid + level, pid);
+}
+
 template <typename Vertex> static Resource getMeshBounds(const Resource handle, MeshResourceData<Vertex> &meshes)
 {
     const u32 pid = GetResourcePoolId(handle);
@@ -1588,6 +1793,11 @@ u32 CombineSamplerTexIntoId(const Resource shandle, const Resource thandle)
 }
 
 // NOTE(Isma): This shouldnt quite be here. Command buffer recording is a different concern
+u64 GetGeneration()
+{
+    return s_Generation;
+}
+
 void UpdateTextureIdOffsetBuffer(const VkCommandBuffer cmd)
 {
     const TKit::StaticHive<i32, ONYX_MAX_TEXTURE_OFFSET_IDS> &offsets = s_Textures->Offsets;
@@ -1638,6 +1848,31 @@ bool IsBackCulled(const Resource handle)
     return s_ResourceData3->ParametricMeshes.Pools[pid].Meshes[rid].Flags & MeshDataFlag_BackCulled;
 }
 
+template <Dimension D> bool HasShortIndices(const Resource handle)
+{
+    ONYX_CHECK_RESOURCE_IS_NOT_NULL(handle);
+    ONYX_CHECK_RESOURCE_POOL_IS_NOT_NULL(handle);
+
+    const ResourceType rtype = GetResourceType(handle);
+    const u32 pid = GetResourcePoolId(handle);
+    const u32 rid = GetResourceId(handle);
+    if (rtype == Resource_StaticMesh)
+        return usesShortIndices(getData<D>().StaticMeshes.Pools[pid].Meshes[rid].Layout.VertexCount);
+    if (rtype == Resource_ParametricMesh)
+        return usesShortIndices(getData<D>().ParametricMeshes.Pools[pid].Meshes[rid].Layout.VertexCount);
+    return false;
+}
+
+bool HasUnifiedMeshBuffers()
+{
+    return s_UnifiedMeshBuffers;
+}
+
+template <typename T> static MeshBuffers getMeshBuffers(const T &data)
+{
+    return {&data.VertexBuffer, &data.IndexBuffer, &data.ShortIndexBuffer};
+}
+
 template <Dimension D> MeshBuffers GetMeshBuffers(const ResourcePool pool)
 {
     ONYX_CHECK_RESOURCE_POOL_IS_NOT_NULL(pool);
@@ -1650,11 +1885,14 @@ template <Dimension D> MeshBuffers GetMeshBuffers(const ResourcePool pool)
     {
     case Resource_StaticMesh:
         ONYX_CHECK_RESOURCE_POOL_IS_VALID(pool, Resource_StaticMesh);
-        return {&getData<D>().StaticMeshes.Pools[pid].VertexBuffer, &getData<D>().StaticMeshes.Pools[pid].IndexBuffer};
+        if (s_UnifiedMeshBuffers)
+            return getMeshBuffers(getData<D>().StaticMeshes);
+        return getMeshBuffers(getData<D>().StaticMeshes.Pools[pid]);
     case Resource_ParametricMesh:
         ONYX_CHECK_RESOURCE_POOL_IS_VALID(pool, Resource_ParametricMesh);
-        return {&getData<D>().ParametricMeshes.Pools[pid].VertexBuffer,
-                &getData<D>().ParametricMeshes.Pools[pid].IndexBuffer};
+        if (s_UnifiedMeshBuffers)
+            return getMeshBuffers(getData<D>().ParametricMeshes);
+        return getMeshBuffers(getData<D>().ParametricMeshes.Pools[pid]);
     case Resource_Font:
         ONYX_CHECK_RESOURCE_POOL_IS_VALID(pool, Resource_Font);
         return {&s_FontData->Pools[pid].VertexBuffer, &s_FontData->Pools[pid].IndexBuffer};
@@ -1752,12 +1990,81 @@ template <typename T> static bool uploadFromHost(VKit::DeviceBuffer &buffer, con
 
 template <typename Vertex> static void uploadMeshPool(MeshPoolData<Vertex> &mpool)
 {
-    uploadFromHost<Vertex>(mpool.VertexBuffer, mpool.Vertices);
-    uploadFromHost<Index>(mpool.IndexBuffer, mpool.Indices);
+    if constexpr (std::is_same_v<Vertex, StaticVertex<D3>>)
+    {
+        if (usesQuantizedVertices<Vertex>())
+            uploadFromHost<QuantizedStaticVertex3>(mpool.VertexBuffer, mpool.QuantizedVertices);
+        else
+            uploadFromHost<Vertex>(mpool.VertexBuffer, mpool.Vertices);
+    }
+    else
+        uploadFromHost<Vertex>(mpool.VertexBuffer, mpool.Vertices);
+    if (mpool.Indices.GetSize() != 0)
+        uploadFromHost<Index>(mpool.IndexBuffer, mpool.Indices);
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        if (mpool.ShortIndices.GetSize() != 0)
+            uploadFromHost<u16>(mpool.ShortIndexBuffer, mpool.ShortIndices);
 
     mpool.Flags = 0;
 }
 
+// pools are packed back to back every time one of them changes. the data of destroyed pools is left in place until then
+template <typename Vertex> static void uploadUnifiedMeshes(MeshResourceData<Vertex> &meshes)
+{
+    bool needsSync = false;
+    for (const MeshPoolData<Vertex> &mpool : meshes.Pools)
+        needsSync |= bool(mpool.Flags & StatusFlag_NeedsSync);
+    if (!needsSync)
+        return;
+
+    u32 vcount = 0;
+    u32 icount = 0;
+    u32 sicount = 0;
+    for (MeshPoolData<Vertex> &mpool : meshes.Pools)
+    {
+        mpool.VertexOffset = vcount;
+        mpool.IndexOffset = icount;
+        mpool.ShortIndexOffset = sicount;
+        vcount += mpool.Vertices.GetSize();
+        icount += mpool.Indices.GetSize();
+        sicount += mpool.ShortIndices.GetSize();
+    }
+
+    const bool quantized = usesQuantizedVertices<Vertex>();
+
+    TKit::DynamicArray<Vertex> vertices{};
+    TKit::DynamicArray<QuantizedStaticVertex3> qvertices{};
+    TKit::DynamicArray<Index> indices{};
+    TKit::DynamicArray<u16> shortIndices{};
+    if (quantized)
+        qvertices.Resize(vcount);
+    else
+        vertices.Resize(vcount);
+    indices.Resize(icount);
+    shortIndices.Resize(sicount);
+    for (MeshPoolData<Vertex> &mpool : meshes.Pools)
+    {
+        if (quantized)
+            TKit::ForwardCopy(qvertices.begin() + mpool.VertexOffset, mpool.QuantizedVertices.begin(),
+                              mpool.QuantizedVertices.end());
+        else
+            TKit::ForwardCopy(vertices.begin() + mpool.VertexOffset, mpool.Vertices.begin(), mpool.Vertices.end());
+        TKit::ForwardCopy(indices.begin() + mpool.IndexOffset, mpool.Indices.begin(), mpool.Indices.end());
+        TKit::ForwardCopy(shortIndices.begin() + mpool.ShortIndexOffset, mpool.ShortIndices.begin(),
+                          mpool.ShortIndices.end());
+        mpool.Flags = 0;
+    }
+
+    if (quantized)
+        uploadFromHost<QuantizedStaticVertex3>(meshes.VertexBuffer, qvertices);
+    else
+        uploadFromHost<Vertex>(meshes.VertexBuffer, vertices);
+    if (icount != 0)
+        uploadFromHost<Index>(meshes.IndexBuffer, indices);
+    if (sicount != 0)
+        uploadFromHost<u16>(meshes.ShortIndexBuffer, shortIndices);
+}
+
 template <typename Vertex> static void uploadMeshes(MeshResourceData<Vertex> &meshes)
 {
     for (const ResourcePool pool : meshes.ToDestroy)
@@ -1768,6 +2075,10 @@ template <typename Vertex> static void uploadMeshes(MeshResourceData<Vertex> &me
 
     meshes.ToDestroy.Clear();
 
+    if constexpr (!std::is_same_v<Vertex, GlyphVertex>)
+        if (s_UnifiedMeshBuffers)
+            return uploadUnifiedMeshes(meshes);
+
     for (MeshPoolData<Vertex> &mpool : meshes.Pools)
         if (mpool.Flags & StatusFlag_NeedsSync)
             uploadMeshPool(mpool);
@@ -1956,6 +2267,7 @@ void Sync(const SyncFlags flags)
     }
 
     Renderer::FlushAllContexts();
+    ++s_Generation;
     TKIT_END_INFO_CLOCK(Milliseconds, "[ONYX][RESOURCES] Uploaded resources in {:.2f} milliseconds");
 }
 
@@ -1982,6 +2294,8 @@ template void DestroyDynamicMesh<D3>(Resource mesh);
 
 template Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D2> &data);
 template Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D3> &data);
+template Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D2> &data, const MeshLodSpecs &specs);
+template Resource RegisterMesh(ResourcePool pool, const StaticMeshData<D3> &data, const MeshLodSpecs &specs);
 
 template void UpdateMesh(Resource handle, const StaticMeshData<D2> &data);
 template void UpdateMesh(Resource handle, const StaticMeshData<D3> &data);
@@ -2022,6 +2336,9 @@ template u32 GetResourceCount<D3>(ResourcePool pool);
 template MeshBuffers GetMeshBuffers<D2>(ResourcePool pool);
 template MeshBuffers GetMeshBuffers<D3>(ResourcePool pool);
 
+template bool HasShortIndices<D2>(Resource handle);
+template bool HasShortIndices<D3>(Resource handle);
+
 template bool IsResourceValid<D2>(Resource handle, ResourceType rtype);
 template bool IsResourceValid<D3>(Resource handle, ResourceType rtype);
 
@@ -2037,4 +2354,7 @@ template MeshDataLayout GetMeshLayout<D3>(Resource handle);
 template Resource GetMeshBounds<D2>(Resource mesh);
 template Resource GetMeshBounds<D3>(Resource mesh);
 
+template Resource SelectMeshLod<D2>(Resource mesh, f32 coverage);
+template Resource SelectMeshLod<D3>(Resource mesh, f32 coverage);
+
 } // namespace Onyx::Resources
@@ -13,13 +13,25 @@ struct MeshBuffers
 {
     const VKit::DeviceBuffer *VertexBuffer = nullptr;
     const VKit::DeviceBuffer *IndexBuffer = nullptr;
+    // holds the indices of the meshes for which HasShortIndices() is true. null for fonts and glyphs
+    const VKit::DeviceBuffer *ShortIndexBuffer = nullptr;
 };
 
 template <Dimension D> MeshBuffers GetMeshBuffers(ResourcePool pool);
+// if true, all static and parametric pools of the same dimension and type share their buffers, and mesh layouts are
+// offset into them
+bool HasUnifiedMeshBuffers();
 MeshBuffers GetFontBuffers(ResourcePool pool);
 MeshBuffers GetGlyphBuffers(ResourcePool pool);
 
 bool IsBackCulled(Resource handle);
+// static and parametric meshes with at most 65536 vertices keep their indices as u16 in the short index buffer of their
+// pool, and their layout index start refers to it
+template <Dimension D> bool HasShortIndices(Resource handle);
+
+// increased whenever meshes, materials, samplers, images or textures change in a way that may alter what is rendered.
+// render textures swapping their images do not count
+u64 GetGeneration();
 
 u32 CombineSamplerTexIntoId(Resource sampler, Resource texture);
 void UpdateTextureIdOffsetBuffer(VkCommandBuffer cmd);
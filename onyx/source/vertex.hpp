@@ -0,0 +1,63 @@
+#pragma once
+
+#include "onyx/vertex.hpp"
+#include "onyx/mesh.hpp"
+
+namespace Onyx
+{
+// defined in context.cpp
+u16 F32ToF16(f32 f);
+
+// device layout of static 3D meshes when Renderer::Specs::QuantizeStaticMeshes is set, at 20 bytes instead of 48.
+// positions are normalized within the bounds of their mesh and the last component holds the tangent sign. the normal
+// and tangent are octahedral encoded and the texture coordinates are half floats
+struct QuantizedStaticVertex3
+{
+    TKit::FixedArray<u16, 4> Position;
+    TKit::FixedArray<i16, 2> Normal;
+    TKit::FixedArray<i16, 2> Tangent;
+    TKit::FixedArray<u16, 2> TexCoord;
+};
+
+inline f32v2 EncodeOctahedral(const f32v3 &direction)
+{
+    const f32 sum = Math::Absolute(direction[0]) + Math::Absolute(direction[1]) + Math::Absolute(direction[2]);
+    if (Math::ApproachesZero(sum))
+        return f32v2{0.f};
+
+    const f32v3 n = direction / sum;
+    if (n[2] >= 0.f)
+        return f32v2{n[0], n[1]};
+
+    return f32v2{(1.f - Math::Absolute(n[1])) * (n[0] >= 0.f ? 1.f : -1.f),
+                 (1.f - Math::Absolute(n[0])) * (n[1] >= 0.f ? 1.f : -1.f)};
+}
+
+inline QuantizedStaticVertex3 QuantizeStaticVertex(const StaticVertex<D3> &vertex, const BoundsData<D3> &bounds)
+{
+    const auto unorm = [](const f32 value) { return u16(Math::Clamp(value, 0.f, 1.f) * 65535.f + 0.5f); };
+    const auto snorm = [](const f32 value) {
+        const f32 scaled = Math::Clamp(value, -1.f, 1.f) * 32767.f;
+        return i16(scaled >= 0.f ? scaled + 0.5f : scaled - 0.5f);
+    };
+
+    QuantizedStaticVertex3 quantized;
+    for (u32 i = 0; i < 3; ++i)
+    {
+        const f32 extent = bounds.Max[i] - bounds.Min[i];
+        quantized.Position[i] =
+            unorm(Math::ApproachesZero(extent) ? 0.f : (vertex.Position[i] - bounds.Min[i]) / extent);
+    }
+    quantized.Position[3] = vertex.Tangent[3] < 0.f ? 0 : 65535;
+
+    const f32v2 normal = EncodeOctahedral(vertex.Normal);
+    const f32v2 tangent = EncodeOctahedral(f32v3{vertex.Tangent});
+    for (u32 i = 0; i < 2; ++i)
+    {
+        quantized.Normal[i] = snorm(normal[i]);
+        quantized.Tangent[i] = snorm(tangent[i]);
+        quantized.TexCoord[i] = F32ToF16(vertex.TexCoord[i]);
+    }
+    return quantized;
+}
+} // namespace Onyx
@@ -7,6 +7,7 @@
 #include "descriptors.hpp"
 #include "core.hpp"
 #include "attachment.hpp"
+#include "buffer.hpp"
 #include "vkit/resource/device_image.hpp"
 #include "vkit/state/descriptor_set.hpp"
 #include "tkit/profiling/macros.hpp"
@@ -25,11 +26,16 @@ static VKit::DeviceImage createAttachment(const VkExtent2D &ext, const Attachmen
         stencilRange.aspectMask = VK_IMAGE_ASPECT_STENCIL_BIT;
         stencilRange.levelCount = 1;
         stencilRange.layerCount = 1;
+
+        // sampled by the depth reduction. the stencil view must remain the last one
+        VkImageSubresourceRange depthRange = stencilRange;
+        depthRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
         return ONYX_CHECK_VKIT_RESULT(VKit::DeviceImage::Builder(device, alloc, ext, format,
                                                                  VKit::DeviceImageFlag_DepthAttachment |
                                                                      VKit::DeviceImageFlag_StencilAttachment |
                                                                      VKit::DeviceImageFlag_Sampled)
                                           .AddImageView()
+                                          .AddImageView(depthRange)
                                           .AddImageView(stencilRange)
                                           .Build());
     }
@@ -39,7 +45,8 @@ static VKit::DeviceImage createAttachment(const VkExtent2D &ext, const Attachmen
         const TKit::FixedArray<VkFormat, 2> ppFormats{format, sformat};
         return ONYX_CHECK_VKIT_RESULT(
             VKit::DeviceImage::Builder(device, alloc, ext, ppFormats,
-                                       VKit::DeviceImageFlag_ColorAttachment | VKit::DeviceImageFlag_Sampled)
+                                       VKit::DeviceImageFlag_ColorAttachment | VKit::DeviceImageFlag_Sampled |
+                                           VKit::DeviceImageFlag_Source)
                 .AddImageView(format)
                 .AddImageView(sformat)
                 .Build());
@@ -52,25 +59,113 @@ static VKit::DeviceImage createAttachment(const VkExtent2D &ext, const Attachmen
             .Build());
 }
 
+// multisampled attachments are only ever rendered to and then resolved into their regular counterparts, so they need
+// not be sampled. a single color image serves both the intermediate and final attachments as they share format
+static VKit::DeviceImage createMultisampledAttachment(const VkExtent2D &ext, const AttachmentType atype,
+                                                      const SampleCount samples)
+{
+    const auto &device = GetDevice();
+    const VmaAllocator alloc = GetVulkanAllocator();
+    const VkFormat format = GetAttachmentFormat(atype);
+    const VKit::DeviceImageFlags flags =
+        atype == Attachment_DepthStencil
+            ? VKit::DeviceImageFlags(VKit::DeviceImageFlag_DepthAttachment | VKit::DeviceImageFlag_StencilAttachment)
+            : VKit::DeviceImageFlags(VKit::DeviceImageFlag_ColorAttachment);
+
+    return ONYX_CHECK_VKIT_RESULT(VKit::DeviceImage::Builder(device, alloc, ext, format, flags)
+                                      .SetSampleCount(AsVulkanSampleCount(samples))
+                                      .AddImageView()
+                                      .Build());
+}
+
 struct Framebuffer
 {
     Execution::Tracker Tracker{};
     TKit::FixedArray<VKit::DeviceImage, Attachment_Count> Attachments{};
+    TKit::FixedArray<VKit::DeviceImage, Attachment_Count> Multisampled{};
+
+    // gpu timestamps around the view's passes, only present with RenderViewFlag_DynamicResolution. the first pair
+    // brackets the opaque, transparent and blend passes, the second one the post process pass, as that one is recorded
+    // separately, after all other views
+    VkQueryPool Timestamps = VK_NULL_HANDLE;
+    u32 TimestampCount = 0;
+
+    // per tile light lists, only present for 3D views with RenderViewFlag_TiledLighting
+    VKit::DeviceBuffer LightTiles{};
+
+    // host visible minimum and maximum depth bits written by the depth reduction, only present for 3D views with
+    // RenderViewFlag_SampleDistributedShadows
+    VKit::DeviceBuffer DepthRange{};
+    bool DepthReduced = false;
 };
 
+static void resetDepthRange(VKit::DeviceBuffer &buffer)
+{
+    u32 *range = scast<u32 *>(buffer.GetData());
+    range[0] = TKIT_U32_MAX;
+    range[1] = 0;
+    ONYX_CHECK_VKIT_RESULT(buffer.Flush());
+}
+
+constexpr u32 s_TimestampQueryCount = 4;
+
+static VkQueryPool createTimestampPool()
+{
+    if (!GetPhysicalDevice().GetInfo().Properties.Core.limits.timestampComputeAndGraphics)
+    {
+        TKIT_LOG_WARNING("[ONYX][VIEW] The device does not support timestamp queries on the graphics queue. Dynamic "
+                         "resolution will not be able to adjust the resolution scale automatically");
+        return VK_NULL_HANDLE;
+    }
+
+    VkQueryPoolCreateInfo info{};
+    info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    info.queryCount = s_TimestampQueryCount;
+
+    const auto &device = GetDevice();
+    const auto table = GetDeviceTable();
+
+    VkQueryPool pool;
+    ONYX_CHECK_VKIT_RESULT(table->CreateQueryPool(device, &info, nullptr, &pool));
+    return pool;
+}
+
+static SampleCount getMaxSampleCount()
+{
+    const VkPhysicalDeviceLimits &limits = GetPhysicalDevice().GetInfo().Properties.Core.limits;
+    const VkSampleCountFlags counts = limits.framebufferColorSampleCounts & limits.framebufferDepthSampleCounts &
+                                      limits.framebufferStencilSampleCounts;
+
+    for (u32 i = SampleCount_Count - 1; i > SampleCount_1; --i)
+        if (counts & AsVulkanSampleCount(SampleCount(i)))
+            return SampleCount(i);
+    return SampleCount_1;
+}
+
+static SampleCount clampSampleCount(const SampleCount samples)
+{
+    const SampleCount maxSamples = getMaxSampleCount();
+    if (samples <= maxSamples)
+        return samples;
+
+    TKIT_LOG_WARNING("[ONYX][VIEW] A sample count of {}x is not supported by the device. Falling back to {}x",
+                     u32(AsVulkanSampleCount(samples)), u32(AsVulkanSampleCount(maxSamples)));
+    return maxSamples;
+}
+
 // NOTE(Isma): Consider having 2D and 3D view sets
-static ViewMask s_ViewCache = TKit::Limits<ViewMask>::Max();
+static ViewMask s_ViewCache = ViewMask::All();
 static ViewMask allocateViewBit()
 {
-    TKIT_ASSERT(s_ViewCache != 0, "[ONYX][VIEW] Maximum amount of views exceeded. There is a hard limit of {} views",
-                8 * sizeof(ViewMask));
+    TKIT_ASSERT(bool(s_ViewCache), "[ONYX][VIEW] Maximum amount of views exceeded. There is a hard limit of {} views",
+                ONYX_MAX_VIEWS);
 
-    const u32 index = u32(std::countr_zero(s_ViewCache));
-    const ViewMask viewBit = 1U << index;
+    const ViewMask viewBit = ViewMask::FromIndex(s_ViewCache.GetFirstIndex());
     s_ViewCache &= ~viewBit;
     return viewBit;
 }
-static void deallocateViewBit(const ViewMask viewBit)
+static void deallocateViewBit(const ViewMask &viewBit)
 {
     s_ViewCache |= viewBit;
 }
@@ -84,8 +179,9 @@ template <Dimension D> static void applyCoordinateSystemExtrinsic(f32m<D> &trans
 }
 
 template <Dimension D>
-RenderView<D>::RenderView(const u32v2 &extent, Camera<D> *camera, const RenderViewFlags flags)
-    : m_Camera(camera), m_ParentExtent(extent), m_Flags(flags)
+RenderView<D>::RenderView(const u32v2 &extent, Camera<D> *camera, const RenderViewFlags flags,
+                          const SampleCount samples)
+    : m_Camera(camera), m_ParentExtent(extent), m_Flags(flags), m_Samples(clampSampleCount(samples))
 
 {
     m_ViewBit = allocateViewBit();
@@ -96,9 +192,23 @@ RenderView<D>::RenderView(const u32v2 &extent, Camera<D> *camera, const RenderVi
         ONYX_CHECK_VKIT_RESULT(pool.Allocate(Descriptors::GetDescriptorLayout(StandalonePass_PostProcess)));
     m_CompositorSet =
         ONYX_CHECK_VKIT_RESULT(pool.Allocate(Descriptors::GetDescriptorLayout(StandalonePass_Compositor)));
+    if constexpr (D == D3)
+    {
+        m_LightTileSet =
+            ONYX_CHECK_VKIT_RESULT(pool.Allocate(Descriptors::GetDescriptorLayout(StandalonePass_LightCull)));
+        m_DepthReduceSet =
+            ONYX_CHECK_VKIT_RESULT(pool.Allocate(Descriptors::GetDescriptorLayout(StandalonePass_DepthReduce)));
+    }
     if (IsDebugUtilsEnabled())
     {
         const auto &device = GetDevice();
+        if constexpr (D == D3)
+        {
+            ONYX_CHECK_VKIT_RESULT(
+                device.SetObjectName(m_LightTileSet, VK_OBJECT_TYPE_DESCRIPTOR_SET, "onyx-light-tile-set-window"));
+            ONYX_CHECK_VKIT_RESULT(
+                device.SetObjectName(m_DepthReduceSet, VK_OBJECT_TYPE_DESCRIPTOR_SET, "onyx-depth-reduce-set-window"));
+        }
         ONYX_CHECK_VKIT_RESULT(
             device.SetObjectName(m_PostProcessSet, VK_OBJECT_TYPE_DESCRIPTOR_SET, "onyx-post-process-set-window"));
         ONYX_CHECK_VKIT_RESULT(
@@ -115,6 +225,11 @@ template <Dimension D> RenderView<D>::~RenderView()
     ONYX_CHECK_VKIT_RESULT(pool.Deallocate(m_BlendSet));
     ONYX_CHECK_VKIT_RESULT(pool.Deallocate(m_PostProcessSet));
     ONYX_CHECK_VKIT_RESULT(pool.Deallocate(m_CompositorSet));
+    if constexpr (D == D3)
+    {
+        ONYX_CHECK_VKIT_RESULT(pool.Deallocate(m_LightTileSet));
+        ONYX_CHECK_VKIT_RESULT(pool.Deallocate(m_DepthReduceSet));
+    }
 
     drainWork();
     destroyFramebuffers();
@@ -130,6 +245,8 @@ template <Dimension D> void RenderView<D>::findAvailableFramebuffer()
         if (!m_Framebuffers[i]->Tracker.InUse())
         {
             m_AttachmentIndex = i;
+            updateResolutionScale(m_Framebuffers[i]);
+            updateSampledDepthRange(m_Framebuffers[i]);
             return;
         }
 
@@ -149,6 +266,54 @@ template <Dimension D> void RenderView<D>::findAvailableFramebuffer()
     for (u32 att = 0; att < Attachment_Count; ++att)
         fb->Attachments[att] = mustCreate[att] ? createAttachment(extent, AttachmentType(att)) : VKit::DeviceImage{};
 
+    if (m_Flags & RenderViewFlag_DynamicResolution)
+        fb->Timestamps = createTimestampPool();
+
+    if constexpr (D == D3)
+        if (m_Flags & RenderViewFlag_TiledLighting)
+        {
+            // sized for the full render extent, as the scaled extent never exceeds it
+            const u32v2 tiles = (GetRenderExtent() + ONYX_LIGHT_TILE_SIZE - 1U) / ONYX_LIGHT_TILE_SIZE;
+            const u32 words = 1 + tiles[0] * tiles[1] * (ONYX_MAX_LIGHTS_PER_TILE + 1);
+            fb->LightTiles = CreateBuffer(Buffer_DeviceStorage, words * sizeof(u32));
+
+            const VkDescriptorBufferInfo info = fb->LightTiles.CreateDescriptorInfo();
+            const VKit::DescriptorSetLayout &layout = Descriptors::GetDescriptorLayout(StandalonePass_LightCull);
+            VKit::DescriptorSet::Writer writer{GetDevice(), &layout};
+            writer.WriteBuffer(ONYX_LIGHT_TILES_BINDING_POINT, info, m_AttachmentIndex);
+            writer.Overwrite(m_LightTileSet);
+        }
+
+    if (reducesDepth())
+    {
+        fb->DepthRange = CreateBuffer(DeviceBufferFlag_Storage | DeviceBufferFlag_HostMapped |
+                                          DeviceBufferFlag_HostRandomAccess,
+                                      2 * sizeof(u32));
+        resetDepthRange(fb->DepthRange);
+
+        VkDescriptorImageInfo depth{};
+        depth.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        depth.imageView = fb->Attachments[Attachment_DepthStencil].GetView(1);
+        depth.sampler = VK_NULL_HANDLE;
+
+        const VkDescriptorBufferInfo range = fb->DepthRange.CreateDescriptorInfo();
+
+        const VKit::DescriptorSetLayout &layout = Descriptors::GetDescriptorLayout(StandalonePass_DepthReduce);
+        VKit::DescriptorSet::Writer writer{GetDevice(), &layout};
+        writer.WriteImage(ONYX_DEPTH_REDUCE_ATTACHMENTS_BINDING, depth, m_AttachmentIndex);
+        writer.WriteBuffer(ONYX_DEPTH_REDUCE_RANGES_BINDING, range, m_AttachmentIndex);
+        writer.Overwrite(m_DepthReduceSet);
+    }
+
+    if (m_Samples != SampleCount_1)
+    {
+        mustCreate[Attachment_Intermediate] = true;
+        mustCreate[Attachment_Final] = false;
+        for (u32 att = 0; att < Attachment_Count; ++att)
+            if (mustCreate[att])
+                fb->Multisampled[att] = createMultisampledAttachment(extent, AttachmentType(att), m_Samples);
+    }
+
     VKit::DescriptorSet::Writer blend{GetDevice(), &Descriptors::GetDescriptorLayout(StandalonePass_Blend)};
     VKit::DescriptorSet::Writer pp{GetDevice(), &Descriptors::GetDescriptorLayout(StandalonePass_PostProcess)};
     VKit::DescriptorSet::Writer compositor{GetDevice(), &Descriptors::GetDescriptorLayout(StandalonePass_Compositor)};
@@ -195,7 +360,9 @@ template <Dimension D> void RenderView<D>::findAvailableFramebuffer()
     VkDescriptorImageInfo &comp = infos.Append();
     comp.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     comp.imageView = fb->Attachments[Attachment_Final].GetView(1);
-    comp.sampler = Renderer::GetNearSampler();
+    // scaled down views are stretched back to their viewport, so they must be filtered
+    comp.sampler = (m_Flags & RenderViewFlag_DynamicResolution) ? Renderer::GetUpscaleSampler()
+                                                                  : Renderer::GetNearSampler();
 
     compositor.WriteImage(ONYX_COMPOSITOR_COLOR_ATTACHMENTS_BINDING, comp, m_AttachmentIndex);
     if (transparency)
@@ -212,12 +379,30 @@ template <Dimension D> void RenderView<D>::findAvailableFramebuffer()
         names[Attachment_Outline] = TKit::StackString::Format("onyx-outline-att-{}", m_AttachmentIndex);
         names[Attachment_DepthStencil] = TKit::StackString::Format("onyx-depth-stencil-att-{}", m_AttachmentIndex);
         names[Attachment_Final] = TKit::StackString::Format("onyx-final-att-{}", m_AttachmentIndex);
+        if (fb->LightTiles)
+        {
+            const TKit::StackString name = TKit::StackString::Format("onyx-light-tiles-{}", m_AttachmentIndex);
+            ONYX_CHECK_VKIT_RESULT(fb->LightTiles.SetName(name.CString()));
+        }
+        if (fb->DepthRange)
+        {
+            const TKit::StackString name = TKit::StackString::Format("onyx-depth-range-{}", m_AttachmentIndex);
+            ONYX_CHECK_VKIT_RESULT(fb->DepthRange.SetName(name.CString()));
+        }
         for (u32 j = 0; j < Attachment_Count; ++j)
+        {
             if (fb->Attachments[j])
             {
                 ONYX_CHECK_VKIT_RESULT(fb->Attachments[j].SetName(names[j].CString()));
                 ONYX_CHECK_VKIT_RESULT(fb->Attachments[j].SetViewNames(names[j].CString()));
             }
+            if (fb->Multisampled[j])
+            {
+                const TKit::StackString msName = TKit::StackString::Format("{}-msaa", names[j].CString());
+                ONYX_CHECK_VKIT_RESULT(fb->Multisampled[j].SetName(msName.CString()));
+                ONYX_CHECK_VKIT_RESULT(fb->Multisampled[j].SetViewNames(msName.CString()));
+            }
+        }
     }
 }
 
@@ -250,10 +435,19 @@ template <Dimension D> void RenderView<D>::drainWork()
 template <Dimension D> void RenderView<D>::destroyFramebuffers()
 {
     TKit::TierAllocator *tier = TKit::GetTier();
+    const auto table = GetDeviceTable();
     for (Framebuffer *fb : m_Framebuffers)
     {
+        if (fb->Timestamps)
+            table->DestroyQueryPool(GetDevice(), fb->Timestamps, nullptr);
         for (VKit::DeviceImage &att : fb->Attachments)
             att.Destroy();
+        for (VKit::DeviceImage &att : fb->Multisampled)
+            att.Destroy();
+        if (fb->LightTiles)
+            fb->LightTiles.Destroy();
+        if (fb->DepthRange)
+            fb->DepthRange.Destroy();
         tier->Destroy(fb);
     }
     m_Framebuffers.Clear();
@@ -317,6 +511,61 @@ template <Dimension D> f32v2 RenderView<D>::WorldToViewport(const f32v<D> &world
     }
 }
 
+template <Dimension D> VKit::DeviceImage &RenderView<D>::GetFinalAttachment()
+{
+    return m_Framebuffers[m_AttachmentIndex]->Attachments[Attachment_Final];
+}
+template <Dimension D> VKit::DeviceBuffer &RenderView<D>::GetLightTiles()
+{
+    return m_Framebuffers[m_AttachmentIndex]->LightTiles;
+}
+
+template <Dimension D> void RenderView<D>::SetSampleCount(const SampleCount samples)
+{
+    const SampleCount clamped = clampSampleCount(samples);
+    if (clamped == m_Samples)
+        return;
+
+    m_Samples = clamped;
+    drainWork();
+    recreateFramebuffers();
+}
+
+template <Dimension D> bool RenderView<D>::HasChanged() const
+{
+    if (!m_Rendered.Valid || m_Rendered.Flags != m_Flags || m_Rendered.ParentExtent != m_ParentExtent ||
+        m_Rendered.Layer != Layer || m_Rendered.ClearColor != ClearColor.rgba || m_Rendered.Samples != m_Samples ||
+        m_Rendered.ResolutionScale != m_ResolutionScale)
+        return true;
+
+    const Viewport &vp = m_Rendered.ViewportArea;
+    const Scissor &sc = m_Rendered.ScissorArea;
+    if (vp.Position != m_Viewport.Position || vp.Extent != m_Viewport.Extent || vp.Depth != m_Viewport.Depth ||
+        sc.Position != m_Scissor.Position || sc.Extent != m_Scissor.Extent)
+        return true;
+
+    const f32m<D> pv =
+        (m_Flags & RenderViewFlag_ManualProjectionView) ? m_Projection * m_View : ComputeProjectionView();
+    for (u32 i = 0; i < D + 1; ++i)
+        if (pv[i] != m_Rendered.ProjectionView[i])
+            return true;
+    return false;
+}
+
+template <Dimension D> void RenderView<D>::MarkRendered()
+{
+    m_Rendered.ProjectionView = m_ProjectionView;
+    m_Rendered.ViewportArea = m_Viewport;
+    m_Rendered.ScissorArea = m_Scissor;
+    m_Rendered.ClearColor = ClearColor.rgba;
+    m_Rendered.ParentExtent = m_ParentExtent;
+    m_Rendered.Layer = Layer;
+    m_Rendered.Flags = m_Flags;
+    m_Rendered.Samples = m_Samples;
+    m_Rendered.ResolutionScale = m_ResolutionScale;
+    m_Rendered.Valid = true;
+}
+
 template <Dimension D> void RenderView<D>::MarkCurrentAttachmentsInUse(const Execution::Tracker &tracker)
 {
     m_Framebuffers[m_AttachmentIndex]->Tracker = tracker;
@@ -376,10 +625,180 @@ static void beginRendering(const VkCommandBuffer cmd, const TKit::Span<const VkR
 // format (view) used is srgb however, for the final window composite pass that merges all views, the format that is
 // used for the final image is unorm. this is because the surface format is unorm (this is required for good imgui
 // support)
+//
+// when a target only has one visible view that covers it entirely (see CoversParent()), the composite pass is skipped
+// and the final image is copied as is into the target. both formats share the same texel layout, so the copy is
+// equivalent to what the compositor would output
+//
+// when multisampling, the opaque and transparent passes render into multisampled versions of their attachments instead,
+// and the last pass that touches each of them resolves it into the regular single sampled attachment. from then on,
+// everything proceeds as usual. color, outline and the oit accumulation and revealage attachments are averaged, while
+// depth stencil takes sample zero, as it is only ever read by the post process pass to find outlines
+
+// render into the multisampled image instead, and resolve into the original one at the end of the pass if requested.
+// the multisampled contents are discarded unless some later pass loads them
+static void useMultisampled(VkRenderingAttachmentInfoKHR &att, const VKit::DeviceImage &msImg,
+                            const VkResolveModeFlagBits mode, const bool resolve, const bool keep)
+{
+    if (resolve)
+    {
+        att.resolveMode = mode;
+        att.resolveImageView = att.imageView;
+        att.resolveImageLayout = att.imageLayout;
+    }
+    att.imageView = msImg.GetView();
+    att.storeOp = keep ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
+// multisampled attachments never leave their attachment layout, so the only hazard to guard against is the previous
+// frame still writing to them
+static void waitForMultisampledColor(const VkCommandBuffer cmd, VKit::DeviceImage &msImg)
+{
+    msImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                            {.SrcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+                             .DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+                             .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                             .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+}
+
+// depth stencil resolves are performed in the color attachment output stage, so when multisampling that is where the
+// regular depth stencil attachment gets written. the depth reduction reads it from a compute shader instead
+static void transitionDepthToShaderRead(const VkCommandBuffer cmd, VKit::DeviceImage &depthImg, const bool multisampled,
+                                        const bool reduce)
+{
+    VkPipelineStageFlags2KHR dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
+    if (reduce)
+        dstStage |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+
+    depthImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                               {
+                                   .SrcAccess = multisampled ? VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+                                                             : VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+                                   .DstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR,
+                                   .SrcStage = multisampled ? VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR
+                                                            : VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+                                   .DstStage = dstStage,
+                               });
+}
+
+template <Dimension D> void RenderView<D>::beginTiming(const VkCommandBuffer cmd, const u32 query)
+{
+    Framebuffer *fb = m_Framebuffers[m_AttachmentIndex];
+    if (!fb->Timestamps)
+        return;
+
+    const auto table = GetDeviceTable();
+    table->CmdResetQueryPool(cmd, fb->Timestamps, query, 2);
+    table->CmdWriteTimestamp2KHR(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR, fb->Timestamps, query);
+}
+
+template <Dimension D> void RenderView<D>::endTiming(const VkCommandBuffer cmd, const u32 query)
+{
+    Framebuffer *fb = m_Framebuffers[m_AttachmentIndex];
+    if (!fb->Timestamps)
+        return;
+
+    const auto table = GetDeviceTable();
+    table->CmdWriteTimestamp2KHR(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, fb->Timestamps, query);
+    fb->TimestampCount = query + 1;
+}
+
+// called once the framebuffer is no longer in use, so its timestamps are guaranteed to be available
+template <Dimension D> void RenderView<D>::updateResolutionScale(Framebuffer *fb)
+{
+    const u32 count = fb->TimestampCount;
+    fb->TimestampCount = 0;
+    if (count == 0 || !(m_Flags & RenderViewFlag_DynamicResolution))
+        return;
+
+    TKit::FixedArray<u64, s_TimestampQueryCount> stamps{};
+    const auto table = GetDeviceTable();
+    const VkResult result = table->GetQueryPoolResults(GetDevice(), fb->Timestamps, 0, count, count * sizeof(u64),
+                                                       stamps.GetData(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+        return;
+
+    u64 ticks = 0;
+    for (u32 i = 0; i < count; i += 2)
+        if (stamps[i + 1] > stamps[i])
+            ticks += stamps[i + 1] - stamps[i];
+    if (ticks == 0)
+        return;
+
+    // timestamp period is given in nanoseconds per tick
+    const f32 period = GetPhysicalDevice().GetInfo().Properties.Core.limits.timestampPeriod;
+    const f32 time = 1e-9f * period * f32(ticks);
+    const f32 target = DynamicResolution.TargetTime.AsSeconds();
+
+    // the cost of these passes is dominated by the amount of shaded pixels, which grows with the square of the scale.
+    // going down is immediate so that load spikes are absorbed in a single frame, while going up is done in small
+    // steps and only with some headroom to avoid oscillating around the target
+    const f32 ratio = Math::SquareRoot(target / time);
+    f32 scale = m_ResolutionScale;
+    if (time > target)
+        scale *= ratio;
+    else if (time < 0.85f * target)
+        scale = Math::Min(scale + 0.02f, scale * ratio);
+
+    m_ResolutionScale = Math::Clamp(scale, DynamicResolution.MinScale, DynamicResolution.MaxScale);
+}
+
+// called once the framebuffer is no longer in use, so the reduction it recorded is guaranteed to be complete
+template <Dimension D> void RenderView<D>::updateSampledDepthRange(Framebuffer *fb)
+{
+    if (!fb->DepthRange)
+        return;
+
+    if (fb->DepthReduced)
+    {
+        fb->DepthReduced = false;
+        ONYX_CHECK_VKIT_RESULT(fb->DepthRange.Invalidate(2 * sizeof(u32)));
+        const u32 *range = scast<const u32 *>(fb->DepthRange.GetData());
+
+        // the range is left untouched when nothing was rendered
+        m_HasSampledDepthRange = range[0] <= range[1];
+        if (m_HasSampledDepthRange)
+        {
+            f32 mn;
+            f32 mx;
+            std::memcpy(&mn, &range[0], sizeof(f32));
+            std::memcpy(&mx, &range[1], sizeof(f32));
+            m_SampledDepthRange = HasReversedDepth() ? f32v2{mx, mn} : f32v2{mn, mx};
+        }
+    }
+    resetDepthRange(fb->DepthRange);
+}
+
+template <Dimension D> void RenderView<D>::EndDepthReduction(const VkCommandBuffer cmd)
+{
+    Framebuffer *fb = m_Framebuffers[m_AttachmentIndex];
+
+    VkBufferMemoryBarrier2KHR barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+    barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT_KHR;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT_KHR;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = fb->DepthRange;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    VkDependencyInfoKHR info{};
+    info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    info.bufferMemoryBarrierCount = 1;
+    info.pBufferMemoryBarriers = &barrier;
+
+    const auto table = GetDeviceTable();
+    table->CmdPipelineBarrier2KHR(cmd, &info);
+    fb->DepthReduced = true;
+}
 
 template <Dimension D> void RenderView<D>::BeginOpaquePass(const VkCommandBuffer cmd)
 {
     TKIT_PROFILE_NSCOPE("Onyx::RenderView::BeginOpaquePass");
+    beginTiming(cmd, 0);
 
     Framebuffer *fb = m_Framebuffers[m_AttachmentIndex];
     TKit::FixedArray<VkRenderingAttachmentInfoKHR, 2> atts{};
@@ -422,21 +841,54 @@ template <Dimension D> void RenderView<D>::BeginOpaquePass(const VkCommandBuffer
                                .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
 
+    const bool reduce = reducesDepth();
+    const bool keepDepth = transparent || hasOutlines || reduce;
+
     VkRenderingAttachmentInfoKHR depth{};
     depth.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
     depth.imageView = depthImg.GetView();
     depth.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depth.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depth.storeOp = (transparent || hasOutlines) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depth.clearValue.depthStencil = {1.f, 0};
+    depth.storeOp = keepDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.clearValue.depthStencil = {HasReversedDepth() ? 0.f : 1.f, 0};
 
+    VkPipelineStageFlags2KHR depthSrcStage =
+        keepDepth ? VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR : VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR;
+    if (reduce)
+        depthSrcStage |= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+
+    const bool multisampled = m_Samples != SampleCount_1;
     depthImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-                               {.DstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
-                                .SrcStage = (transparent || hasOutlines) ? VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR
-                                                                         : VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR,
-                                .DstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR});
+                               {.DstAccess = multisampled ? VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR
+                                                          : VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+                                .SrcStage = depthSrcStage,
+                                .DstStage = multisampled ? VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR
+                                                         : VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR});
 
-    const u32v2 ext = GetRenderExtent();
+    if (multisampled)
+    {
+        VKit::DeviceImage &msColor = fb->Multisampled[Attachment_Intermediate];
+        VKit::DeviceImage &msOutline = fb->Multisampled[Attachment_Outline];
+        VKit::DeviceImage &msDepth = fb->Multisampled[Attachment_DepthStencil];
+
+        // the blend pass works on the resolved color, so only outlines and depth need to survive for the transparent
+        // pass, which will then be the one resolving them
+        useMultisampled(color, msColor, VK_RESOLVE_MODE_AVERAGE_BIT_KHR, true, false);
+        useMultisampled(outline, msOutline, VK_RESOLVE_MODE_AVERAGE_BIT_KHR, hasOutlines && !transparent,
+                        hasOutlines && transparent);
+        useMultisampled(depth, msDepth, VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR, (hasOutlines || reduce) && !transparent,
+                        transparent);
+
+        waitForMultisampledColor(cmd, msColor);
+        waitForMultisampledColor(cmd, msOutline);
+        msDepth.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                  {.SrcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+                                   .DstAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
+                                   .SrcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
+                                   .DstStage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR});
+    }
+
+    const u32v2 ext = GetScaledRenderExtent();
     beginRendering(cmd, atts, depth, ext, GetNormalizedScissor());
 }
 
@@ -466,7 +918,6 @@ template <Dimension D> void RenderView<D>::EndOpaquePass(const VkCommandBuffer c
                                        .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                    });
         if (hasPostProcess)
-        {
             outlImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                                       {
                                           .SrcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
@@ -475,15 +926,10 @@ template <Dimension D> void RenderView<D>::EndOpaquePass(const VkCommandBuffer c
                                           .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
                                           .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                       });
-            depthImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                       {
-                                           .SrcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
-                                           .DstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR,
-
-                                           .SrcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
-                                           .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
-                                       });
-        }
+        const bool reduce = reducesDepth();
+        if (hasPostProcess || reduce)
+            transitionDepthToShaderRead(cmd, depthImg, m_Samples != SampleCount_1, reduce);
+        endTiming(cmd, 1);
     }
 }
 
@@ -540,10 +986,29 @@ template <Dimension D> void RenderView<D>::BeginTransparentPass(const VkCommandB
     depth.imageView = depthImg.GetView();
     depth.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
     depth.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-    depth.storeOp = hasOutlines ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    depth.clearValue.depthStencil = {1.f, 0};
+    const bool keepDepth = hasOutlines || reducesDepth();
+    depth.storeOp = keepDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth.clearValue.depthStencil = {HasReversedDepth() ? 0.f : 1.f, 0};
 
-    const u32v2 ext = GetRenderExtent();
+    if (m_Samples != SampleCount_1)
+    {
+        VKit::DeviceImage &msTransparent = fb->Multisampled[Attachment_Transparent];
+        VKit::DeviceImage &msRevealage = fb->Multisampled[Attachment_Revealage];
+
+        // weighted blended oit accumulates per sample, so averaging both accumulation and revealage yields the same
+        // coverage weighted result the blend pass would compute with a per sample resolve
+        useMultisampled(color, msTransparent, VK_RESOLVE_MODE_AVERAGE_BIT_KHR, true, false);
+        useMultisampled(revealage, msRevealage, VK_RESOLVE_MODE_AVERAGE_BIT_KHR, true, false);
+        useMultisampled(outline, fb->Multisampled[Attachment_Outline], VK_RESOLVE_MODE_AVERAGE_BIT_KHR, hasOutlines,
+                        false);
+        useMultisampled(depth, fb->Multisampled[Attachment_DepthStencil], VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR,
+                        keepDepth, false);
+
+        waitForMultisampledColor(cmd, msTransparent);
+        waitForMultisampledColor(cmd, msRevealage);
+    }
+
+    const u32v2 ext = GetScaledRenderExtent();
     beginRendering(cmd, atts, depth, ext, GetNormalizedScissor());
 }
 
@@ -591,7 +1056,7 @@ template <Dimension D> void RenderView<D>::BeginBlendPass(const VkCommandBuffer
     color.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
     color.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
     color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    const u32v2 ext = GetRenderExtent();
+    const u32v2 ext = GetScaledRenderExtent();
 
     beginRendering(cmd, color, {}, ext, GetNormalizedScissor());
 }
@@ -619,7 +1084,6 @@ template <Dimension D> void RenderView<D>::EndBlendPass(const VkCommandBuffer cm
     if (hasPostProcess)
     {
         VKit::DeviceImage &outlImg = fb->Attachments[Attachment_Outline];
-        VKit::DeviceImage &depthImg = fb->Attachments[Attachment_DepthStencil];
         outlImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                                   {
                                       .SrcAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
@@ -627,19 +1091,17 @@ template <Dimension D> void RenderView<D>::EndBlendPass(const VkCommandBuffer cm
                                       .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
                                       .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                   });
-        depthImg.TransitionLayout2(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                                   {
-                                       .SrcAccess = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT_KHR,
-                                       .DstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR,
-                                       .SrcStage = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR,
-                                       .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
-                                   });
     }
+    const bool reduce = reducesDepth();
+    if (hasPostProcess || reduce)
+        transitionDepthToShaderRead(cmd, fb->Attachments[Attachment_DepthStencil], m_Samples != SampleCount_1, reduce);
+    endTiming(cmd, 1);
 }
 
 template <Dimension D> void RenderView<D>::BeginPostProcess(const VkCommandBuffer cmd)
 {
     TKIT_PROFILE_NSCOPE("Onyx::View::BeginPostProcess");
+    beginTiming(cmd, 2);
 
     Framebuffer *fb = m_Framebuffers[m_AttachmentIndex];
 
@@ -657,7 +1119,7 @@ template <Dimension D> void RenderView<D>::BeginPostProcess(const VkCommandBuffe
                                 .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                 .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
 
-    const u32v2 ext = GetRenderExtent();
+    const u32v2 ext = GetScaledRenderExtent();
     beginRendering(cmd, color, {}, ext, GetNormalizedScissor());
 }
 
@@ -677,6 +1139,7 @@ template <Dimension D> void RenderView<D>::EndPostProcess(const VkCommandBuffer
                                    .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
                                    .DstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
                                });
+    endTiming(cmd, 3);
 }
 
 template <Dimension D> f32m<D> RenderView<D>::ComputeView() const
@@ -709,7 +1172,9 @@ template <Dimension D> f32m<D> RenderView<D>::ComputeProjection() const
         const PerspectiveParameters &pparams = m_Camera->PerspParameters;
 
         if (m_Camera->Mode == CameraMode_Perspective)
-            return Transform<D3>::Perspective(pparams.FieldOfView, pparams.Near, pparams.Far, aspect);
+            return pparams.ReversedDepth
+                       ? Transform<D3>::ReversedPerspective(pparams.FieldOfView, pparams.Near, aspect)
+                       : Transform<D3>::Perspective(pparams.FieldOfView, pparams.Near, pparams.Far, aspect);
         if (m_Camera->Mode == CameraMode_Orthographic)
             return Transform<D3>::Orthographic(oparams.Size, aspect, oparams.Near, oparams.Far);
         return Transform<D3>::Orthographic(viewport.Extent[1], aspect, oparams.Near, oparams.Far);
@@ -503,12 +503,46 @@ void Window::Present()
     presentInfo.pSwapchains = &swapChain;
     presentInfo.pImageIndices = &m_ImageIndex;
 
+    const u64 id = m_PresentId + 1;
+    VkPresentIdKHR presentId{};
+    if (IsPresentWaitSupported())
+    {
+        presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentId.swapchainCount = 1;
+        presentId.pPresentIds = &id;
+        presentInfo.pNext = &presentId;
+    }
+
     const auto table = GetDeviceTable();
     const VkResult result = table->QueuePresentKHR(*m_Present, &presentInfo);
+    m_PresentId = id;
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR)
+    {
+        m_PreviousPresentId = m_LastPresentId;
+        m_LastPresentId = id;
+    }
 
+    // may reset the last present id if the swapchain gets recreated
     handlePresentOrAcquireResult(result);
 }
 
+bool Window::WaitForPreviousPresent(const Timeout timeout)
+{
+    if (!IsPresentWaitSupported() || m_PreviousPresentId == 0)
+        return false;
+
+    TKIT_PROFILE_NSCOPE("Onyx::Window::WaitForPreviousPresent");
+    const auto table = GetDeviceTable();
+    const auto &device = GetDevice();
+
+    const VkResult result = table->WaitForPresentKHR(device, *m_Swapchain, m_PreviousPresentId, timeout);
+    if (result == VK_TIMEOUT || result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_ERROR_SURFACE_LOST_KHR)
+        return false;
+
+    ONYX_CHECK_VKIT_RESULT(result);
+    return true;
+}
+
 bool Window::AcquireNextImage(const Timeout timeout)
 {
     TKIT_PROFILE_NSCOPE("Onyx::Window::AcquireNextImage");
@@ -577,6 +611,7 @@ void Window::createSwapchain(const u32v2 &windowExtent)
             .RequestExtent(AsVulkanExtent(windowExtent))
             .RequestImageCount(3)
             .SetOldSwapchain(*m_Swapchain)
+            .AddImageUsageFlags(VK_IMAGE_USAGE_TRANSFER_DST_BIT)
             .AddFlags(VKit::SwapchainBuilderFlag_Clipped | VKit::SwapchainBuilderFlag_CreateImageViews)
             .Build());
     extractSwapchainImages();
@@ -677,6 +712,9 @@ void Window::recreateResources()
     destroySyncData();
     createSyncData();
     m_ImageIndex = 0;
+    // present ids of the old swapchain can no longer be waited on
+    m_LastPresentId = 0;
+    m_PreviousPresentId = 0;
 }
 
 VkSemaphore Window::GetImageAvailableSemaphore() const
@@ -693,25 +731,57 @@ void Window::MarkImageSemaphoreInUse(const Execution::Tracker &tracker)
     m_SyncData[m_SyncIndex]->Tracker = tracker;
 }
 
-void Window::BeginRendering(const VkCommandBuffer cmd)
+void Window::BeginRendering(const VkCommandBuffer cmd, VKit::DeviceImage *source)
 {
     TKIT_PROFILE_NSCOPE("Onyx::Window::BeginRendering");
 
     VKit::DeviceImage *pimage = m_Presentation[m_ImageIndex];
+    const VkExtent2D &extent = m_Swapchain->GetInfo().Extent;
+    const auto table = GetDeviceTable();
+
     VkRenderingAttachmentInfoKHR present{};
     present.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
     present.imageView = pimage->GetView();
     present.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    present.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     present.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    present.clearValue.color = {{ClearColor.rgba[0], ClearColor.rgba[1], ClearColor.rgba[2], ClearColor.rgba[3]}};
 
-    pimage->TransitionLayout2(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                              {.DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
-                               .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
-                               .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+    if (source)
+    {
+        source->TransitionLayout2(cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                  {.DstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                                   .SrcStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR,
+                                   .DstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR});
+        pimage->TransitionLayout2(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                  {.DstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                                   .SrcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+                                   .DstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR});
+
+        VkImageCopy region{};
+        region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+        region.extent = {extent.width, extent.height, 1};
+        table->CmdCopyImage(cmd, *source, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *pimage,
+                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        pimage->TransitionLayout2(
+            cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            {.SrcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+             .DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT_KHR | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+             .SrcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+             .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+        present.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    }
+    else
+    {
+        pimage->TransitionLayout2(cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                  {.DstAccess = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT_KHR,
+                                   .SrcStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                                   .DstStage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR});
+        present.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        present.clearValue.color = {
+            {ClearColor.rgba[0], ClearColor.rgba[1], ClearColor.rgba[2], ClearColor.rgba[3]}};
+    }
 
-    const VkExtent2D &extent = m_Swapchain->GetInfo().Extent;
     VkRenderingInfoKHR renderInfo{};
     renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
     renderInfo.renderArea = {{0, 0}, extent};
@@ -719,7 +789,6 @@ void Window::BeginRendering(const VkCommandBuffer cmd)
     renderInfo.colorAttachmentCount = 1;
     renderInfo.pColorAttachments = &present;
 
-    const auto table = GetDeviceTable();
     table->CmdBeginRenderingKHR(cmd, &renderInfo);
 }
 